@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+    GL dependency: mirrors a ContainerType::Tracked component array into a GL buffer object.
+
+    struct ModelMatrix {
+        using container_type = LEapsGL::ContainerType::Tracked;
+        using instance_type = glm::mat4;
+    };
+
+    LEapsGL::ComponentBuffer<ModelMatrix> instanceBuffer;
+    ...
+    world.patch<ModelMatrix>(entt, [&](glm::mat4& m) { m = transform; });
+    instanceBuffer.sync(world);  // glBufferSubData for the changed ranges only
+*/
+
+#include <glad/glad.h>
+#include <core/World.h>
+
+namespace LEapsGL {
+
+    template <typename Type>
+    class ComponentBuffer {
+    public:
+        using pool_type = traits::to_container_t<Type>;
+        using instance_type = traits::to_instance_t<Type>;
+
+        static_assert(__internal::is_tracked_pool<pool_type>::value, "ComponentBuffer requires ContainerType::Tracked.");
+
+        explicit ComponentBuffer(const GLenum target = GL_ARRAY_BUFFER, const GLenum usage = GL_DYNAMIC_DRAW) : target(target), usage(usage) {};
+        ComponentBuffer(const ComponentBuffer&) = delete;
+        ComponentBuffer& operator=(const ComponentBuffer&) = delete;
+        ~ComponentBuffer() {
+            if (buffer != 0) glDeleteBuffers(1, &buffer);
+        }
+
+        /**
+         * @brief Bring the buffer up to date with the pool.
+         *
+         * Re-specifies the whole store when the array outgrew it; otherwise uploads only the dirty ranges.
+         * Ranges separated by at most merge_gap clean slots are sent as one call.
+         *
+         * @return Number of bytes uploaded.
+         */
+        size_t sync(pool_type& pool, const size_t merge_gap = 0) {
+            if (buffer == 0) glGenBuffers(1, &buffer);
+            glBindBuffer(target, buffer);
+
+            count = pool.size();
+            if (count > capacity) {
+                capacity = std::max(count, capacity * 2);
+                glBufferData(target, capacity * sizeof(instance_type), nullptr, usage);
+                glBufferSubData(target, 0, count * sizeof(instance_type), pool.data());
+                pool.clear_dirty();
+                return count * sizeof(instance_type);
+            }
+
+            size_t uploaded = 0;
+            pool.flush_dirty([this, &uploaded](const size_t first, const size_t n, const instance_type* data) {
+                glBufferSubData(target, first * sizeof(instance_type), n * sizeof(instance_type), data);
+                uploaded += n * sizeof(instance_type);
+            }, merge_gap);
+            return uploaded;
+        }
+        template <typename Entity, typename Allocator>
+        size_t sync(World<Entity, Allocator>& world, const size_t merge_gap = 0) {
+            return sync(world.template assure<Type>(), merge_gap);
+        }
+
+        GLuint id() const noexcept {
+            return buffer;
+        }
+        // Number of valid elements after the last sync.
+        size_t size() const noexcept {
+            return count;
+        }
+
+    private:
+        GLuint buffer = 0;
+        GLenum target;
+        GLenum usage;
+        size_t capacity = 0;
+        size_t count = 0;
+    };
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <unordered_map>
+#include <map>
+#include <functional>
+#include <type_traits>
+
+#include <core/entity.h>
+
+namespace LEapsGL {
+
+    /*-----------------------------------------------------------------------*/
+    // Secondary (key -> entity) index, declared per component:
+    //struct Name {
+    //    using instance_type = std::string;
+    //    using index_type = LEapsGL::IndexType::Hashed<>;
+    //          // => Hashed<KeyFn>, Ordered<KeyFn> (default: no index)
+    // };
+    //struct GridCell {
+    //    using instance_type = glm::ivec2;
+    //    struct CellKey { int64_t operator()(const glm::ivec2& c) const { return (int64_t(c.y) << 32) | uint32_t(c.x); } };
+    //    using index_type = LEapsGL::IndexType::Ordered<CellKey>;
+    // };
+    // KeyFn maps `const instance_type&` to the key; the default uses the instance itself.
+    // Indexed components must be modified through World::patch so the index can follow the key.
+    /*-----------------------------------------------------------------------*/
+    struct IndexType {
+        struct IndexTypeBase {};
+        // Key is the instance itself.
+        struct Self {
+            template <typename T>
+            constexpr const T& operator()(const T& value) const noexcept {
+                return value;
+            }
+        };
+        // Exact-match lookups (names, resource hashes).
+        template <typename KeyFn = Self>
+        struct Hashed : public IndexTypeBase {};
+        // Exact-match and range lookups (grid cells, layers, depth buckets).
+        template <typename KeyFn = Self>
+        struct Ordered : public IndexTypeBase {};
+    };
+
+    /*
+        Both indices expose the same interface to IndexedComponentPool:
+            void insert(const instance_type&, Entity);
+            void erase(const instance_type&, Entity);
+            Entity find(key) const;          // any entity with the key, or null
+            size_t count(key) const;
+            void each_equal(key, fn) const;  // fn(Entity)
+        Ordered additionally provides each_range(lo, hi, fn) over [lo, hi).
+    */
+    template <typename Entity, typename Instance, typename KeyFn, typename Map>
+    class basic_component_index {
+    public:
+        using key_type = typename Map::key_type;
+
+        void insert(const Instance& value, const Entity& entt) {
+            map.emplace(KeyFn{}(value), entt);
+        }
+        void erase(const Instance& value, const Entity& entt) {
+            auto range = map.equal_range(KeyFn{}(value));
+            for (auto iter = range.first; iter != range.second; ++iter) {
+                if (iter->second == entt) {
+                    map.erase(iter);
+                    return;
+                }
+            }
+        }
+        void clear() {
+            map.clear();
+        }
+        // Keys are unchanged; only the stored handles are rewritten.
+        template <typename Remap>
+        void remap(const Remap& table) {
+            for (auto& entry : map) entry.second = table(entry.second);
+        }
+
+        Entity find(const key_type& key) const {
+            auto iter = map.find(key);
+            if (iter == map.end()) return LEapsGL::null;
+            return iter->second;
+        }
+        size_t count(const key_type& key) const {
+            return map.count(key);
+        }
+        template <typename Fun>
+        void each_equal(const key_type& key, Fun fn) const {
+            auto range = map.equal_range(key);
+            for (auto iter = range.first; iter != range.second; ++iter) fn(iter->second);
+        }
+        size_t size() const noexcept {
+            return map.size();
+        }
+
+    protected:
+        Map map;
+    };
+
+    template <typename Instance, typename KeyFn>
+    using index_key_t = std::decay_t<std::invoke_result_t<KeyFn, const Instance&>>;
+
+    template <typename Entity, typename Instance, typename KeyFn>
+    using hashed_component_index = basic_component_index<Entity, Instance, KeyFn, std::unordered_multimap<index_key_t<Instance, KeyFn>, Entity>>;
+
+    template <typename Entity, typename Instance, typename KeyFn>
+    class ordered_component_index : public basic_component_index<Entity, Instance, KeyFn, std::multimap<index_key_t<Instance, KeyFn>, Entity>> {
+        using super = basic_component_index<Entity, Instance, KeyFn, std::multimap<index_key_t<Instance, KeyFn>, Entity>>;
+
+    public:
+        using key_type = typename super::key_type;
+
+        // Every entity whose key lies in [lo, hi), in key order.
+        template <typename Fun>
+        void each_range(const key_type& lo, const key_type& hi, Fun fn) const {
+            for (auto iter = this->map.lower_bound(lo), last = this->map.lower_bound(hi); iter != last; ++iter) fn(iter->second);
+        }
+    };
+
+    namespace __internal {
+        template <typename Tag, typename Entity, typename Instance>
+        struct ComponentIndexSelector;
+
+        template <typename KeyFn, typename Entity, typename Instance>
+        struct ComponentIndexSelector<IndexType::Hashed<KeyFn>, Entity, Instance> {
+            using type = hashed_component_index<Entity, Instance, KeyFn>;
+        };
+        template <typename KeyFn, typename Entity, typename Instance>
+        struct ComponentIndexSelector<IndexType::Ordered<KeyFn>, Entity, Instance> {
+            using type = ordered_component_index<Entity, Instance, KeyFn>;
+        };
+
+        template <typename T, typename = void>
+        struct HasComponentIndex : std::false_type {};
+
+        template <typename T>
+        struct HasComponentIndex<T, std::void_t<typename T::index_type>> : std::true_type {};
+    }
+
+    namespace traits {
+        template <typename ComponentType, typename Entity, typename Instance>
+        using to_component_index_t = typename __internal::ComponentIndexSelector<typename ComponentType::index_type, Entity, Instance>::type;
+    }
+}
@@ -4,15 +4,24 @@
 
 #include <core/Type.h>
 #include <core/entity.h>
+#include <core/SparseIndex.h>
+#include <core/ComponentIndex.h>
+#include <core/PageCodec.h>
+#include <core/MappedFile.h>
+#include <core/CowStorage.h>
 
 #include <stdio.h>
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <optional>
+#include <array>
+#include <memory>
 #include <cassert>
 #include <string>
+#include <stdexcept>
 #include <queue>
+#include <atomic>
 using namespace std;
 
 #define CONTAINER_DEBUG_LOG_ON true
@@ -36,10 +45,6 @@ using namespace std;
 
 namespace LEapsGL{
 
-    constexpr size_t pageBits = 12;
-    constexpr size_t pageMask = (1 << 12) - 1;
-
-
     namespace __internal {
         template <typename T, typename = void>
         struct CInstanceTypeSelector {
@@ -78,6 +83,59 @@ namespace LEapsGL{
 
     // simple sparse
 
+    namespace __internal {
+        // Swap-remove helper: fill the hole at idx with the last element (caller pops the back).
+        template <typename Storage>
+        inline void relocate_last_into(Storage& storage, const size_t idx) {
+            using T = typename Storage::value_type;
+            const size_t last = storage.size() - 1;
+            if (idx == last) return;
+            if constexpr (std::is_trivially_copyable_v<T>) std::memcpy(static_cast<void*>(&storage[idx]), &storage[last], sizeof(T));
+            else storage[idx] = std::move(storage[last]);
+        }
+    }
+
+    namespace __internal {
+        // Unique across pools and never reused, so equal stamps mean an unchanged packed array.
+        inline std::uint64_t next_membership_stamp() noexcept {
+            static std::atomic<std::uint64_t> clock{ 0 };
+            return ++clock;
+        }
+    }
+
+    /*
+        Old -> new handle table produced by World::defragment_ids(). Handles that were not alive when
+        the table was built map to null, so stale references held outside the world stay invalid.
+    */
+    template <typename Entity>
+    class entity_remap {
+        using traits_type = LEapsGL::entity_traits<Entity>;
+
+    public:
+        entity_remap() = default;
+        explicit entity_remap(const size_t ids) : from(ids, Entity{ LEapsGL::null }), to(ids, Entity{ LEapsGL::null }) {}
+
+        void set(const Entity& old, const Entity& renumbered) {
+            const size_t id = static_cast<size_t>(traits_type::to_entity(old));
+            from[id] = old;
+            to[id] = renumbered;
+        }
+        Entity operator()(const Entity& old) const {
+            const size_t id = static_cast<size_t>(traits_type::to_entity(old));
+            if (id >= from.size() || from[id] != old) return LEapsGL::null;
+            return to[id];
+        }
+        // True if any live handle changed.
+        bool changed() const noexcept {
+            for (size_t i = 0; i < from.size(); i++) if (from[i] != to[i]) return true;
+            return false;
+        }
+
+    private:
+        std::vector<Entity> from;
+        std::vector<Entity> to;
+    };
+
     template <typename Entity>
     class ContainerBase {
     public:
@@ -89,6 +147,23 @@ namespace LEapsGL{
         virtual bool remove(const Entity& entt) = 0;
         virtual void emplace(const Entity& entt) = 0;
         virtual bool contains(const Entity& entt) const = 0;
+        // Release spare capacity (called when a world is frozen).
+        virtual void shrink_to_fit() {};
+        // Commit double-buffered components at the end of a frame (see DoubleBufferedComponentPool).
+        virtual void swap_buffers() {};
+        // Rewrite every stored handle after World::defragment_ids(); component positions do not change.
+        virtual void remap(const entity_remap<Entity>& table) = 0;
+
+        // Count of writes World made through this pool (see RunCondition::Changed); only compare it for equality.
+        std::uint64_t change_count() const noexcept {
+            return changes;
+        }
+        void mark_changed() noexcept {
+            changes++;
+        }
+
+    private:
+        std::uint64_t changes = 0;
     };
 
     /*
@@ -110,13 +185,111 @@ namespace LEapsGL{
 //    };
 
 
+    /*
+        Packed entity list shared by every sparse_array regardless of its sparse index strategy,
+        so a View can drive iteration from any of its pools through one pointer type.
+    */
     template <typename Entity, typename Allocator = std::allocator<Entity>>
-    class sparse_array : public ContainerBase <Entity>{
+    class packed_set : public ContainerBase <Entity>{
     protected:
-        using alloc_traits = std::allocator_traits<Allocator>;
-        using sparse_type = std::vector <typename alloc_traits::pointer, typename alloc_traits::template rebind_alloc<typename alloc_traits::pointer>>;
         using packed_type = std::vector<Entity, Allocator>;
 
+    public:
+        using iterator = typename packed_type::iterator;
+        using const_iterator = typename packed_type::const_iterator;
+
+        size_t size() const {
+            return packed.size();
+        }
+        iterator begin() {
+            return packed.begin();
+        }
+        const_iterator begin() const { return packed.begin(); };
+
+        iterator end() {
+            return packed.end();
+        }
+        const_iterator end() const { return packed.end(); };
+
+        void shrink_to_fit() override {
+            packed.shrink_to_fit();
+        }
+        void remap(const entity_remap<Entity>& table) override {
+            for (auto& entt : packed) entt = table(entt);
+            touch();
+        }
+        // Changes on every modification of packed; World's rollback ring shares packed arrays with equal stamps.
+        std::uint64_t membership_stamp() const noexcept {
+            return stamp;
+        }
+
+        packed_type packed;
+
+    protected:
+        void touch() noexcept {
+            stamp = __internal::next_membership_stamp();
+        }
+
+    private:
+        std::uint64_t stamp = 0;
+    };
+
+    /*
+        One bit per entity id (e.g. the disabled entities of a world). A test is a single word load,
+        cheaper than any pool probe, and toggling never touches the pools.
+    */
+    template <typename Entity>
+    class entity_bitset {
+        using traits_type = LEapsGL::entity_traits<Entity>;
+        using word_type = std::uint64_t;
+        static constexpr size_t word_bits = 64;
+
+    public:
+        inline bool test(const Entity& entt) const noexcept {
+            const size_t id = static_cast<size_t>(traits_type::to_entity(entt));
+            const size_t word = id / word_bits;
+            return word < words.size() && ((words[word] >> (id % word_bits)) & 1u);
+        }
+        // Returns false if the bit was already set.
+        bool set(const Entity& entt) {
+            const size_t id = static_cast<size_t>(traits_type::to_entity(entt));
+            const size_t word = id / word_bits;
+            if (words.size() <= word) words.resize(word + 1, 0);
+
+            const word_type mask = word_type{ 1 } << (id % word_bits);
+            if (words[word] & mask) return false;
+            words[word] |= mask;
+            bits++;
+            return true;
+        }
+        // Returns false if the bit was not set.
+        bool reset(const Entity& entt) noexcept {
+            if (!test(entt)) return false;
+            const size_t id = static_cast<size_t>(traits_type::to_entity(entt));
+            words[id / word_bits] &= ~(word_type{ 1 } << (id % word_bits));
+            bits--;
+            return true;
+        }
+        void clear() noexcept {
+            words.clear();
+            bits = 0;
+        }
+        size_t count() const noexcept {
+            return bits;
+        }
+
+    private:
+        std::vector<word_type> words;
+        size_t bits = 0;
+    };
+
+    template <typename Entity, typename Allocator = std::allocator<Entity>, typename SparseIndex = paged_sparse_index<Entity, Allocator>>
+    class sparse_array : public packed_set<Entity, Allocator> {
+    protected:
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using sparse_type = SparseIndex;
+        using packed_type = typename packed_set<Entity, Allocator>::packed_type;
+
         using traits_type = LEapsGL::entity_traits<Entity>;
         using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
         using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
@@ -125,18 +298,11 @@ namespace LEapsGL{
     private:
         void release() {
             CONTAINER_DEBUG_LOG("Sparse array released..");
-
-            auto page_allocator{ packed.get_allocator() };
-
-            for (auto&& page : sparse) {
-                if (page != nullptr) {
-                    std::destroy(page, page + (1 << pageBits));
-                    alloc_traits::deallocate(page_allocator, page, (1 << pageBits));
-                    page = nullptr;
-                }
-            }
+            sparse.clear();
         }
     public:
+        using packed_base = packed_set<Entity, Allocator>;
+        using packed_base::packed;
 
         using iterator = typename packed_type::iterator;
         using const_iterator = typename packed_type::const_iterator;
@@ -145,36 +311,31 @@ namespace LEapsGL{
             release();
         }
         Entity* sparse_ptr(const Entity& entt) const {
-            const auto entity_id = traits_type::to_entity(entt);
-
-            const size_t bucketID = entity_id >> pageBits;
-            const size_t idx = entity_id & pageMask;
-
-            if (sparse.size() <= bucketID || !sparse[bucketID]) return nullptr;
-            return &sparse[bucketID][idx];
+            return sparse.find(traits_type::to_entity(entt));
         }
         inline Entity& sparse_get(const Entity& entt) const {
-            const auto entity_id = traits_type::to_entity(entt);
-            const size_t bucketID = entity_id >> pageBits;
-            const size_t idx = entity_id & pageMask;
-            return sparse[bucketID][idx];
+            return sparse.get(traits_type::to_entity(entt));
         }
 
         auto& assure_sparse_get(const Entity& entt) {
-            const auto entity_id = traits_type::to_entity(entt);
-
-            const size_t bucketID = entity_id >> pageBits;
-            const size_t idx = entity_id & pageMask;
-
-            if (sparse.size() <= bucketID)
-                sparse.resize(bucketID + 1, nullptr);
+            return sparse.assure(traits_type::to_entity(entt));
+        }
 
-            if (!sparse[bucketID]) {
-                auto alloc{ packed.get_allocator() };
-                sparse[bucketID] = alloc_traits::allocate(alloc, 1 << pageBits);
-                std::uninitialized_fill(sparse[bucketID], sparse[bucketID] + (1 << pageBits), LEapsGL::null);
-            }
-            return sparse[bucketID][idx];
+        size_t sparse_memory_usage() const {
+            return sparse.memory_usage();
+        }
+        inline void prefetch_sparse(const Entity& entt) const {
+            sparse.prefetch(traits_type::to_entity(entt));
+        }
+        // Packed position recorded in the sparse slot of entt, or size_t(-1) if there is none.
+        // The slot may be stale: membership still requires packed[idx] == entt.
+        inline size_t packed_index(const Entity& entt) const {
+            auto* packed_idx = sparse_ptr(entt);
+            if (packed_idx == nullptr || *packed_idx == LEapsGL::null) return static_cast<size_t>(-1);
+            return static_cast<size_t>(traits_type::to_entity(*packed_idx));
+        }
+        inline void prefetch_at(const size_t idx) const {
+            LEAPS_PREFETCH(packed.data() + idx);
         }
 
         bool contains(const Entity& entt) const noexcept {
@@ -203,51 +364,57 @@ namespace LEapsGL{
             auto& packed_idx = assure_sparse_get(entt);
             packed_idx = traits_type::construct(packed.size(), 0);
             packed.emplace_back(entt);
+            this->touch();
+        }
+        // Bulk insertion: one reservation for all entities (prefab instantiation).
+        void emplace_n(const Entity* first, const size_t count) {
+            const size_t offset = packed.size();
+            packed.insert(packed.end(), first, first + count);
+            for (size_t i = 0; i < count; i++) {
+                assure_sparse_get(first[i]) = traits_type::construct(static_cast<entity_type>(offset + i), 0);
+            }
+            this->touch();
+        }
+        // Renumbered ids are rebuilt into a fresh sparse index, so pages only cover the compacted id range.
+        void remap(const entity_remap<Entity>& table) override {
+            packed_base::remap(table);
+            sparse.clear();
+            for (size_t i = 0; i < packed.size(); i++) {
+                assure_sparse_get(packed[i]) = traits_type::construct(static_cast<entity_type>(i), 0);
+            }
         }
         virtual bool remove(const Entity& entt) {
             if (!contains(entt)) return false;
             CONTAINER_DEBUG_LOG("Remove Sparse Array : " << to_string(traits_type::to_entity(entt)));
 
-            assert(contains(entt), "The remove function was called on an element that was not included.");
-
-            Entity& lastSparseItem = sparse_get(packed.back());
-            Entity& targetSparseItem = sparse_get(entt);
+            assert(contains(entt) && "The remove function was called on an element that was not included.");
 
-            std::swap(packed[traits_type::to_entity(targetSparseItem)], packed[traits_type::to_entity(lastSparseItem)]);
-            std::swap(targetSparseItem, lastSparseItem);
+            // Move only the last entry into the hole; the removed slot is cleared afterwards.
+            const auto idx = traits_type::to_entity(sparse_get(entt));
+            const Entity last = packed.back();
+            packed[idx] = last;
+            assure_sparse_get(last) = traits_type::construct(idx, 0);
             packed.pop_back();
+            sparse.erase(traits_type::to_entity(entt));
+            this->touch();
 
             return true;
         }
 
-        size_t size() const {
-            return packed.size();
-        }
-        iterator begin() {
-            return packed.begin();
-        }
-        const_iterator begin() const { return packed.begin(); };
-
-        iterator end() {
-            return packed.end();
-        }
-        const_iterator end() const { return packed.end(); };
-
         sparse_type sparse;
-        packed_type packed;
     };
 
-    template<typename Entity, typename Type>
+    template<typename Entity, typename Type, typename Storage = traits::to_component_storage_t<traits::to_instance_t<Type>>>
     struct ComponentPoolIterator {
-        using instance_type = traits::to_instance_t<typename Type>;
+        using instance_type = traits::to_instance_t<Type>;
 
     private:
         int curIdx;
         vector<Entity>* packed;
-        vector<instance_type>* components;
+        Storage* components;
 
     public:
-        ComponentPoolIterator(vector<Entity>* _packed, vector<instance_type>* _components, int idx = 0) : packed{ _packed }, components{ _components }, curIdx(idx) {};
+        ComponentPoolIterator(vector<Entity>* _packed, Storage* _components, int idx = 0) : curIdx(idx), packed{ _packed }, components{ _components } {};
         ComponentPoolIterator& operator++() {
             curIdx++;
             return *this;
@@ -272,17 +439,17 @@ namespace LEapsGL{
         }
     };
 
-    template<typename Entity, typename Type>
+    template<typename Entity, typename Type, typename Storage = traits::to_component_storage_t<traits::to_instance_t<Type>>>
     struct ComponentPoolConstIterator {
         using instance_type = typename traits::to_instance_t<Type>;
 
     private:
         int curIdx;
         vector<Entity>* packed;
-        vector<instance_type>* components;
+        Storage* components;
 
     public:
-        ComponentPoolConstIterator(vector<Entity>* _packed, vector<instance_type>* _components, int idx = 0) : packed{ _packed }, components{ _components }, curIdx(idx) {};
+        ComponentPoolConstIterator(vector<Entity>* _packed, Storage* _components, int idx = 0) : curIdx(idx), packed{ _packed }, components{ _components } {};
         ComponentPoolConstIterator& operator++() {
             curIdx++;
             return *this;
@@ -307,15 +474,17 @@ namespace LEapsGL{
         }
     };
 
-    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
-    class DefaultComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>> {
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>,
+        typename Storage = traits::to_pool_storage_t<Type, traits::to_instance_t<Type>>,
+        typename SparseIndex = traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>>
+    class DefaultComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, SparseIndex> {
         using alloc_traits = std::allocator_traits<Allocator>;
     public:
         using traits_type = LEapsGL::entity_traits<Entity>;
         using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
         using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
         using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
-        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>;
+        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, SparseIndex>;
         using instance_type = typename traits::to_instance_t<Type>;
         
         std::tuple<instance_type&> get_as_tuple(const Entity& entt) {
@@ -327,32 +496,50 @@ namespace LEapsGL{
         instance_type& get(const Entity& entt) {
             return components[(size_t)traits_type::to_entity(super::sparse_get(entt))];
         }
+        // Read-only access: never copies a page shared with a World::fork() copy.
+        const instance_type& get(const Entity& entt) const {
+            return components[(size_t)traits_type::to_entity(super::sparse_get(entt))];
+        }
+        std::tuple<instance_type&> get_at_as_tuple(const size_t idx) {
+            return std::forward_as_tuple(components[idx]);
+        }
+        inline void prefetch_at(const size_t idx) const {
+            super::prefetch_at(idx);
+            LEAPS_PREFETCH(&components[idx]);
+        }
+        // Component array in packed order.
+        const instance_type* data() const noexcept {
+            return components.data();
+        }
 
         void emplace(const value_type& entt, instance_type&& arg) {
             super::emplace(entt);
             components.emplace_back(std::forward<instance_type>(arg));
         };
+        // Every entity receives a copy of value; trivially copyable values become a single fill.
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            super::emplace_n(first, count);
+            components.insert(components.end(), count, value);
+        }
 
         bool remove(const Entity& entt) override {
-            using std::swap;
-            static_assert(std::is_swappable_v<instance_type>, "Error");
+            static_assert(std::is_move_assignable_v<instance_type>, "Component instance must be move assignable.");
 
             if (!super::contains(entt)) return false;
 
             CONTAINER_DEBUG_LOG("Removed from component pool : " << std::to_string(traits_type::to_entity(entt)));
 
-            const auto idx = (size_t)this->sparse_get(entt);
+            const auto idx = (size_t)traits_type::to_entity(this->sparse_get(entt));
             auto out = super::remove(entt);
             if (!out) return false;
 
-            swap(components[idx], components.back());
-
+            __internal::relocate_last_into(components, idx);
             components.pop_back();
             return true;
         }
 
-        using iterator = ComponentPoolIterator<Entity, instance_type>;
-        using const_iterator = ComponentPoolConstIterator<Entity, instance_type>;
+        using iterator = ComponentPoolIterator<Entity, instance_type, Storage>;
+        using const_iterator = ComponentPoolConstIterator<Entity, instance_type, Storage>;
         iterator begin() {
             return iterator(&this->packed, &components, 0);
         }
@@ -365,19 +552,82 @@ namespace LEapsGL{
         const_iterator end() const {
             return const_iterator(&this->packed, &components, 0);
         }
+        void shrink_to_fit() override {
+            super::shrink_to_fit();
+            components.shrink_to_fit();
+        }
+    protected:
+        Storage components;
+    };
+
+    /**
+     * @brief Default pool that also keeps last frame's committed values (ContainerType::DoubleBuffered).
+     *
+     * get(), views and patch() address the write buffer; previous() reads the committed buffer, which
+     * nothing writes until swap_buffers() (called by Universe::Update after every system has run). Systems
+     * may therefore read any entity's previous state while writing their own in parallel, without locks
+     * or ordering, as long as each entity is written by a single thread. After a swap the write buffer
+     * starts as a copy of the newly committed values, so partial updates keep the untouched state.
+     * Emplace and remove change both buffers and are not thread-safe.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
+    class DoubleBufferedComponentPool : public DefaultComponentPool<Type, Entity, Allocator> {
+    public:
+        using super = DefaultComponentPool<Type, Entity, Allocator>;
+        using traits_type = typename super::traits_type;
+        using value_type = typename super::value_type;
+        using instance_type = typename super::instance_type;
+
+        // Last frame's committed value of entt.
+        const instance_type& previous(const Entity& entt) const {
+            return committed[(size_t)traits_type::to_entity(this->sparse_get(entt))];
+        }
+        const instance_type& previous_at(const size_t idx) const {
+            return committed[idx];
+        }
+
+        void emplace(const value_type& entt, instance_type&& arg) {
+            super::emplace(entt, std::forward<instance_type>(arg));
+            committed.emplace_back(std::as_const(this->components).back());
+        }
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            super::emplace_n(first, count, value);
+            committed.insert(committed.end(), count, value);
+        }
+        bool remove(const Entity& entt) override {
+            if (!super::contains(entt)) return false;
+
+            const auto idx = (size_t)traits_type::to_entity(this->sparse_get(entt));
+            if (!super::remove(entt)) return false;
+
+            __internal::relocate_last_into(committed, idx);
+            committed.pop_back();
+            return true;
+        }
+
+        // Commit this frame's writes: they become previous() and the seed of the next frame.
+        void swap_buffers() override {
+            const auto& written = std::as_const(this->components);
+            for (size_t i = 0; i < committed.size(); i++) committed[i] = written[i];
+        }
+        void shrink_to_fit() override {
+            super::shrink_to_fit();
+            committed.shrink_to_fit();
+        }
+
     private:
-        vector<instance_type> components;
+        traits::to_pool_storage_t<Type, instance_type> committed;
     };
 
     template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
-    class MemoryOptimizedComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>> {
+    class MemoryOptimizedComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>> {
         using alloc_traits = std::allocator_traits<Allocator>;
     public:
         using traits_type = LEapsGL::entity_traits<Entity>;
         using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
         using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
         using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
-        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>;
+        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>>;
 
         using instance_type = typename traits::to_instance_t<Type>;
 
@@ -396,20 +646,42 @@ namespace LEapsGL{
             for (const auto& x : this->packed) if (x == entt) return true;
             return false;
         }
+        // No sparse index to rebuild.
+        void remap(const entity_remap<Entity>& table) override {
+            super::packed_base::remap(table);
+        }
+        // No sparse index: the position is found by a linear scan.
+        size_t packed_index(const Entity& entt) const {
+            for (size_t i = 0; i < this->packed.size(); i++) if (entt == this->packed[i]) return i;
+            return static_cast<size_t>(-1);
+        }
+        std::tuple<instance_type&> get_at_as_tuple(const size_t idx) {
+            return std::forward_as_tuple(components[idx]);
+        }
+        inline void prefetch_at(const size_t idx) const {
+            LEAPS_PREFETCH(components.data() + idx);
+        }
         void emplace(const Entity& entt, instance_type&& arg) {
             this->packed.emplace_back(entt);
             components.emplace_back(std::forward<instance_type>(arg));
+            this->touch();
         };
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            this->packed.insert(this->packed.end(), first, first + count);
+            components.insert(components.end(), count, value);
+            this->touch();
+        }
         bool remove(const Entity& entt) override {
             if (!contains(entt)) return false;
 
             CONTAINER_DEBUG_LOG("Removed from component pool : " << to_string(entt));
 
             const auto idx = (size_t)get_index(entt);
-            std::swap(this->packed[idx], this->packed.back());
-            std::swap(components[idx], components.back());
+            __internal::relocate_last_into(this->packed, idx);
+            __internal::relocate_last_into(components, idx);
             this->packed.pop_back();
             components.pop_back();
+            this->touch();
             return true;
         }
         // -------------------------------------------------
@@ -427,23 +699,27 @@ namespace LEapsGL{
         const_iterator end() const {
             return const_iterator(&this->packed, &components, 0);
         }
+        void shrink_to_fit() override {
+            super::shrink_to_fit();
+            components.shrink_to_fit();
+        }
     private:
         inline size_t get_index(const Entity& entt) {
             for (size_t i = 0; i < this->packed.size(); i++) if (entt == this->packed[i]) return i;
-            assert(false, "get_index should guarantee the presence of data.");
+            assert(false && "get_index should guarantee the presence of data.");
         }
-        vector<instance_type> components;
+        traits::to_component_storage_t<instance_type> components;
     };
 
     template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
-    class FlagComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>> {
+    class FlagComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>> {
         using alloc_traits = std::allocator_traits<Allocator>;
     public:
         using traits_type = LEapsGL::entity_traits<Entity>;
         using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
         using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
         using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
-        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>;
+        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>>;
         using packed_type = typename super::packed_type;
 
         struct Iterator {
@@ -520,73 +796,1218 @@ namespace LEapsGL{
         // -------------------------------------------------
     };
 
-    //
-    //template <typename Entity, typename Value, typename GetHash, typename GetEqual>
-    //class ContextContainer : public ContainerBase <Entity> {
-    //    using traits_type = LEapsGL::entity_traits<Entity>;
-    //    using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
-    //    using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
-    //    using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
-    //    using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>;
+    /**
+     * @brief Pool for world-level resources: at most one instance, stored inline.
+     *
+     * The instance may be owned by an entity (emplace) or set without one (emplace_resource).
+     * A View binds a unique pool directly: every iterated entity receives the resource,
+     * without a membership test, and the view never drives iteration from it unless all of its pools are unique.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
+    class UniqueComponentPool : public packed_set<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>> {
+    public:
+        using traits_type = LEapsGL::entity_traits<Entity>;
+        using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
+        using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
+        using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
+        using super = packed_set<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>;
+        using packed_base = super;
+        using instance_type = typename traits::to_instance_t<Type>;
 
-    //private:       
-    //    std::unordered_map<Entity, Value, GetHash, GetEqual> context;
-    //};
+        static constexpr bool is_unique = true;
 
-    //template<typename Type, typename Entity = LEapsGL::entity, typename Allocator = std::allocator<std::remove_const_t<Type>>>
-    //struct component_pool_for {
-    //    /*! @brief Type-to-storage conversion result. */
-    //    using type = constness_as_t<storage_type_t<std::remove_const_t<Type>, Entity, Allocator>, Type>;
-    //};
-    //
-    //template<typename Type>
-    //using component_pool_for_type = typename component_pool_for<Type, Entity, typename alloc_traits::template rebind_alloc<std::remove_const_t<Type>>>::type;
+        struct Iterator {
+        private:
+            int curIdx;
+            typename super::packed_type* packed;
+            std::optional<instance_type>* value;
 
+        public:
+            Iterator(typename super::packed_type* _packed, std::optional<instance_type>* _value, int idx = 0) : curIdx(idx), packed{ _packed }, value{ _value } {};
+            Iterator& operator++() {
+                curIdx++;
+                return *this;
+            }
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+            tuple<const Entity, instance_type&> operator*() {
+                return std::tuple_cat(
+                    std::make_tuple((*packed)[curIdx]),
+                    std::forward_as_tuple(**value)
+                );
+            }
+            bool operator==(const Iterator& rhs) const noexcept {
+                return rhs.curIdx == curIdx && rhs.packed == packed;
+            }
+            bool operator!=(const Iterator& rhs) const noexcept {
+                return !operator==(rhs);
+            }
+        };
+        using iterator = Iterator;
 
-    template<typename T, typename Tuple>
-    struct type_index;
+        // Views bind the resource to every entity, so the entity only selects the pool interface.
+        std::tuple<instance_type&> get_as_tuple(const Entity&) {
+            assert(value.has_value());
+            return std::forward_as_tuple(*value);
+        }
+        std::tuple<const instance_type&> get_as_tuple(const Entity&) const {
+            assert(value.has_value());
+            return std::forward_as_tuple(*value);
+        }
+        instance_type& get(const Entity&) {
+            assert(value.has_value());
+            return *value;
+        }
+        instance_type& get() {
+            return *value;
+        }
+        bool has_value() const noexcept {
+            return value.has_value();
+        }
 
+        bool contains(const Entity& entt) const noexcept override {
+            return !this->packed.empty() && this->packed.front() == entt;
+        }
+        // Hand the resource over to another entity.
+        void emplace(const Entity& entt) override {
+            if (!value) throw std::logic_error("UniqueComponentPool: no resource to hand over");
+            this->packed.assign(1, entt);
+            this->touch();
+        }
+        void emplace(const Entity& entt, instance_type&& arg) {
+            emplace_resource(std::forward<instance_type>(arg));
+            emplace(entt);
+        }
+        instance_type& emplace_resource(instance_type&& arg) {
+            value.emplace(std::forward<instance_type>(arg));
+            return *value;
+        }
+        bool remove(const Entity& entt) override {
+            if (!contains(entt)) return false;
 
-    template <typename T, typename... Others>
-    struct type_index<T, std::tuple<T, Others...>> {
-        static constexpr size_t value = 0;
-    };
+            CONTAINER_DEBUG_LOG("Removed from unique pool : " << std::to_string(traits_type::to_entity(entt)));
+            reset();
+            return true;
+        }
+        void reset() {
+            this->packed.clear();
+            value.reset();
+            this->touch();
+        }
 
-    template <typename T, typename U, typename... Others>
-    struct type_index<T, std::tuple<U, Others...>> {
-        static constexpr size_t value = 1 + type_index<T, std::tuple<Others...>>::value;
+        iterator begin() {
+            return iterator(&this->packed, &value, 0);
+        }
+        iterator end() {
+            return iterator(&this->packed, &value, this->packed.size());
+        }
+    private:
+        std::optional<instance_type> value;
     };
 
+    namespace __internal {
+        template <typename T, typename = void>
+        struct CSharedHashSelector {
+            using type = std::hash<traits::to_instance_t<T>>;
+        };
 
-    template <typename ... ComponentPoolTypes>
-    struct W_ComponentPool {};
-
-    template <typename ... FilterPools>
-    struct Filter {};
-
-    template <typename...>
-    class View;
-
-    template <typename... ComponentPoolTypes, typename... Filters>
-    class View<W_ComponentPool<ComponentPoolTypes...>, Filter<Filters...>>{
-    private:
-        using Entity = std::common_type_t<typename ComponentPoolTypes::value_type...>;
-        using super_type = std::common_type_t<typename ComponentPoolTypes::super...>;
+        template <typename T>
+        struct CSharedHashSelector<T, std::void_t<typename T::hash_type>> {
+            using type = typename T::hash_type;
+        };
+    }
 
+    /**
+     * @brief Pool that stores each distinct component value once.
+     *
+     * Entities hold a 32-bit slot index into a refcounted value table; equal values
+     * (operator== under T::hash_type, default std::hash) share one slot. Values are read-only
+     * through get(); patch()/replace() copy the value, apply the change and re-intern it (copy-on-write).
+     * sort_by_value() orders the packed array so entities sharing a value are contiguous.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
+    class SharedComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>> {
+    public:
+        using traits_type = LEapsGL::entity_traits<Entity>;
         using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
         using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
         using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
-        using traits_type = LEapsGL::entity_traits<Entity>;
+        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>>;
+        using instance_type = typename traits::to_instance_t<Type>;
+        using hasher = typename __internal::CSharedHashSelector<Type>::type;
+        using slot_type = std::uint32_t;
 
-        template<typename T>
+        struct Iterator {
+        private:
+            int curIdx;
+            const SharedComponentPool* pool;
+
+        public:
+            Iterator(const SharedComponentPool* _pool, int idx = 0) : curIdx(idx), pool{ _pool } {};
+            Iterator& operator++() {
+                curIdx++;
+                return *this;
+            }
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+            tuple<const Entity, const instance_type&> operator*() const {
+                return std::tuple_cat(
+                    std::make_tuple(pool->packed[curIdx]),
+                    std::forward_as_tuple(*pool->values[pool->indices[curIdx]])
+                );
+            }
+            bool operator==(const Iterator& rhs) const noexcept {
+                return rhs.curIdx == curIdx && rhs.pool == pool;
+            }
+            bool operator!=(const Iterator& rhs) const noexcept {
+                return !operator==(rhs);
+            }
+        };
+        using iterator = Iterator;
+        using const_iterator = Iterator;
+
+        std::tuple<const instance_type&> get_as_tuple(const Entity& entt) const {
+            return std::forward_as_tuple(get(entt));
+        }
+        const instance_type& get(const Entity& entt) const {
+            return *values[indices[position(entt)]];
+        }
+        std::tuple<const instance_type&> get_at_as_tuple(const size_t idx) const {
+            return std::forward_as_tuple(*values[indices[idx]]);
+        }
+        inline void prefetch_at(const size_t idx) const {
+            super::prefetch_at(idx);
+            LEAPS_PREFETCH(indices.data() + idx);
+        }
+
+        void emplace(const Entity& entt, instance_type&& arg) {
+            super::emplace(entt);
+            indices.push_back(intern(std::forward<instance_type>(arg)));
+            sorted = false;
+        }
+        // All entities share one slot: the value is interned once.
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            if (count == 0) return;
+            super::emplace_n(first, count);
+            const slot_type slot = intern(instance_type(value));
+            refcounts[slot] += static_cast<std::uint32_t>(count - 1);
+            indices.insert(indices.end(), count, slot);
+            sorted = false;
+        }
+        bool remove(const Entity& entt) override {
+            if (!super::contains(entt)) return false;
+
+            CONTAINER_DEBUG_LOG("Removed from shared pool : " << std::to_string(traits_type::to_entity(entt)));
+
+            const auto idx = position(entt);
+            const auto slot = indices[idx];
+            super::remove(entt);
+
+            indices[idx] = indices.back();
+            indices.pop_back();
+            release(slot);
+            sorted = false;
+            return true;
+        }
+
+        // Copy-on-write mutation: the entity gets a private copy, which is merged back if it equals another value.
+        template <typename Fun>
+        const instance_type& patch(const Entity& entt, Fun fn) {
+            auto& slot = indices[position(entt)];
+            instance_type copy = *values[slot];
+            fn(copy);
+            return rebind(slot, std::move(copy));
+        }
+        const instance_type& replace(const Entity& entt, instance_type&& arg) {
+            return rebind(indices[position(entt)], std::forward<instance_type>(arg));
+        }
+
+        // Number of distinct values currently stored.
+        size_t value_count() const noexcept {
+            return values.size() - freeSlots.size();
+        }
+        size_t use_count(const Entity& entt) const {
+            return refcounts[indices[position(entt)]];
+        }
+
+        // Reorder packed entities by slot so equal values form contiguous runs.
+        void sort_by_value() {
+            if (sorted) return;
+
+            std::vector<size_t> order(this->packed.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) { return indices[lhs] < indices[rhs]; });
+
+            typename super::packed_type sortedPacked(this->packed.size());
+            std::vector<slot_type> slots(indices.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                sortedPacked[i] = this->packed[order[i]];
+                slots[i] = indices[order[i]];
+                this->assure_sparse_get(sortedPacked[i]) = traits_type::construct(static_cast<entity_type>(i), 0);
+            }
+            this->packed.swap(sortedPacked);
+            this->touch();
+            indices.swap(slots);
+            sorted = true;
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+        const_iterator end() const {
+            return const_iterator(this, this->packed.size());
+        }
+
+    private:
+        inline size_t position(const Entity& entt) const {
+            return static_cast<size_t>(traits_type::to_entity(this->sparse_get(entt)));
+        }
+
+        slot_type intern(instance_type&& arg) {
+            const size_t h = hasher{}(arg);
+            auto range = lookup.equal_range(h);
+            for (auto iter = range.first; iter != range.second; ++iter) {
+                if (*values[iter->second] == arg) {
+                    refcounts[iter->second]++;
+                    return iter->second;
+                }
+            }
+
+            slot_type slot;
+            if (freeSlots.empty()) {
+                slot = static_cast<slot_type>(values.size());
+                values.emplace_back(std::forward<instance_type>(arg));
+                refcounts.push_back(1);
+                hashes.push_back(h);
+            }
+            else {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+                values[slot].emplace(std::forward<instance_type>(arg));
+                refcounts[slot] = 1;
+                hashes[slot] = h;
+            }
+            lookup.emplace(h, slot);
+            return slot;
+        }
+        void release(const slot_type slot) {
+            if (--refcounts[slot] > 0) return;
+
+            auto range = lookup.equal_range(hashes[slot]);
+            for (auto iter = range.first; iter != range.second; ++iter) {
+                if (iter->second == slot) {
+                    lookup.erase(iter);
+                    break;
+                }
+            }
+            values[slot].reset();
+            freeSlots.push_back(slot);
+        }
+        const instance_type& rebind(slot_type& slot, instance_type&& arg) {
+            const slot_type previous = slot;
+            slot = intern(std::forward<instance_type>(arg));
+            release(previous);
+            if (slot != previous) sorted = false;
+            return *values[slot];
+        }
+
+        std::vector<slot_type> indices; // parallel to packed
+        std::vector<std::optional<instance_type>> values;
+        std::vector<std::uint32_t> refcounts;
+        std::vector<size_t> hashes;
+        std::vector<slot_type> freeSlots;
+        std::unordered_multimap<size_t, slot_type> lookup;
+        bool sorted = true;
+    };
+
+    /**
+     * @brief Component pool with a secondary key -> entity index (Type::index_type).
+     *
+     * Wraps a value pool (Default / MemoryOptimized) and keeps the index in step on emplace, emplace_n,
+     * remove and patch. Writes through get() bypass the index, so keyed fields must be changed with patch().
+     */
+    template <typename Type, typename Entity, typename Base>
+    class IndexedComponentPool : public Base {
+    public:
+        using super = Base;
+        using instance_type = typename Base::instance_type;
+        using index_type = traits::to_component_index_t<Type, Entity, instance_type>;
+
+        static constexpr bool is_indexed = true;
+
+        void emplace(const Entity& entt, instance_type&& arg) {
+            super::emplace(entt, std::forward<instance_type>(arg));
+            index_.insert(super::get(entt), entt);
+        }
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            super::emplace_n(first, count, value);
+            for (size_t i = 0; i < count; i++) index_.insert(value, first[i]);
+        }
+        bool remove(const Entity& entt) override {
+            if (!super::contains(entt)) return false;
+            index_.erase(super::get(entt), entt);
+            return super::remove(entt);
+        }
+
+        // Modify in place and re-key the entity.
+        template <typename Fun>
+        instance_type& patch(const Entity& entt, Fun fn) {
+            auto& value = super::get(entt);
+            index_.erase(value, entt);
+            fn(value);
+            index_.insert(value, entt);
+            return value;
+        }
+
+        const index_type& index() const noexcept {
+            return index_;
+        }
+        void remap(const entity_remap<Entity>& table) override {
+            super::remap(table);
+            index_.remap(table);
+        }
+
+    private:
+        index_type index_;
+    };
+
+    /*
+        Modified slot ranges [begin, end) of a component array, coalesced on demand.
+        Marks in ascending order (appends, sequential patches) merge in place; others are sorted at coalesce().
+    */
+    class dirty_ranges {
+    public:
+        using range_type = std::pair<size_t, size_t>;
+
+        void mark(const size_t first, const size_t last) {
+            if (first >= last) return;
+            if (!marks.empty()) {
+                auto& back = marks.back();
+                if (first <= back.second && last >= back.first) {
+                    back.first = std::min(back.first, first);
+                    back.second = std::max(back.second, last);
+                    // Grown downwards into (or before) the range ahead of it: no longer in order.
+                    if (marks.size() > 1 && back.first <= marks[marks.size() - 2].second) sorted = false;
+                    return;
+                }
+                if (first < back.second) sorted = false;
+            }
+            marks.emplace_back(first, last);
+        }
+        void mark(const size_t idx) {
+            mark(idx, idx + 1);
+        }
+
+        // Sort, merge ranges closer than merge_gap slots, and clip to [0, limit).
+        void coalesce(const size_t limit, const size_t merge_gap = 0) {
+            if (!sorted) std::sort(marks.begin(), marks.end());
+            sorted = true;
+
+            size_t out = 0;
+            for (const auto& range : marks) {
+                const size_t first = range.first;
+                const size_t last = std::min(range.second, limit);
+                if (first >= last) continue;
+                if (out > 0 && first <= marks[out - 1].second + merge_gap) marks[out - 1].second = std::max(marks[out - 1].second, last);
+                else marks[out++] = range_type(first, last);
+            }
+            marks.resize(out);
+        }
+
+        const std::vector<range_type>& ranges() const noexcept {
+            return marks;
+        }
+        bool empty() const noexcept {
+            return marks.empty();
+        }
+        void clear() noexcept {
+            marks.clear();
+            sorted = true;
+        }
+
+    private:
+        std::vector<range_type> marks;
+        bool sorted = true;
+    };
+
+    /**
+     * @brief Default pool that records which slots of its component array changed (ContainerType::Tracked).
+     *
+     * emplace/emplace_n mark the appended slots, remove marks the slot that received the last element,
+     * and patch/mark_dirty mark the entity's slot. Writes through get() or a View are not seen; call
+     * mark_dirty() or mark_all_dirty() for those. flush_dirty() hands out the coalesced ranges together with
+     * a pointer into the array, e.g. for glBufferSubData (see ComponentBuffer.h), and resets the record.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
+    class TrackedComponentPool : public DefaultComponentPool<Type, Entity, Allocator> {
+    public:
+        using super = DefaultComponentPool<Type, Entity, Allocator>;
+        using traits_type = typename super::traits_type;
+        using instance_type = typename super::instance_type;
+
+        static constexpr bool is_tracked = true;
+
+        void emplace(const Entity& entt, instance_type&& arg) {
+            super::emplace(entt, std::forward<instance_type>(arg));
+            dirty_.mark(this->size() - 1);
+        }
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            const size_t offset = this->size();
+            super::emplace_n(first, count, value);
+            dirty_.mark(offset, offset + count);
+        }
+        bool remove(const Entity& entt) override {
+            if (!super::contains(entt)) return false;
+            const size_t idx = super::packed_index(entt);
+            super::remove(entt);
+            if (idx < this->size()) dirty_.mark(idx);
+            return true;
+        }
+
+        template <typename Fun>
+        instance_type& patch(const Entity& entt, Fun fn) {
+            auto& value = super::get(entt);
+            fn(value);
+            mark_dirty(entt);
+            return value;
+        }
+        void mark_dirty(const Entity& entt) {
+            dirty_.mark(super::packed_index(entt));
+        }
+        void mark_all_dirty() {
+            dirty_.mark(0, this->size());
+        }
+
+        const dirty_ranges& dirty() const noexcept {
+            return dirty_;
+        }
+        void clear_dirty() noexcept {
+            dirty_.clear();
+        }
+
+        // upload(first, count, const instance_type* data) per coalesced range; the record is cleared afterwards.
+        template <typename Fun>
+        void flush_dirty(Fun upload, const size_t merge_gap = 0) {
+            dirty_.coalesce(this->size(), merge_gap);
+            for (const auto& range : dirty_.ranges()) upload(range.first, range.second - range.first, this->data() + range.first);
+            dirty_.clear();
+        }
+
+    private:
+        dirty_ranges dirty_;
+    };
+
+    /*
+        Variable-length component value: elements [offset, offset + length) of a pool's arena.
+        The slice keeps the arena by address, so it stays valid when the arena grows or is defragmented;
+        pointers from begin()/data() do not. Length changes go through ArenaComponentPool.
+    */
+    template <typename T, typename Arena>
+    class arena_slice {
+    public:
+        using value_type = T;
+        using size_type = std::uint32_t;
+
+        arena_slice(Arena* _arena, const size_type _offset, const size_type _length) : arena{ _arena }, offset{ _offset }, length{ _length }, capacity{ _length } {};
+
+        T* data() const noexcept {
+            return arena->data() + offset;
+        }
+        T* begin() const noexcept {
+            return data();
+        }
+        T* end() const noexcept {
+            return data() + length;
+        }
+        T& operator[](const size_t i) const noexcept {
+            return data()[i];
+        }
+        size_t size() const noexcept {
+            return length;
+        }
+        bool empty() const noexcept {
+            return length == 0;
+        }
+
+    private:
+        template <typename, typename, typename>
+        friend class ArenaComponentPool;
+
+        Arena* arena;
+        size_type offset;
+        size_type length;
+        size_type capacity; // reserved elements at offset
+    };
+
+    /**
+     * @brief Pool for variable-length components: every entity's elements live in one shared arena.
+     *
+     * The component declares the list it logically holds, e.g. `using instance_type = std::vector<Entity>;`;
+     * emplace copies it into the arena and get() returns an arena_slice over the elements. Growing a slice
+     * that cannot extend in place moves it to the arena tail (doubling its reservation) and leaves a hole;
+     * removed entities leave holes too. defragment() repacks all slices in packed order so a sweep over the
+     * pool is linear. It runs automatically once holes outweigh live elements.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<Entity>>
+    class ArenaComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>> {
+    public:
+        using traits_type = LEapsGL::entity_traits<Entity>;
+        using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
+        using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
+        using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
+        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>>;
+        using list_type = typename traits::to_instance_t<Type>;
+        using element_type = typename list_type::value_type;
+        using arena_type = traits::to_component_storage_t<element_type>;
+        using instance_type = arena_slice<element_type, arena_type>;
+
+        static_assert(std::is_default_constructible_v<element_type>, "Arena elements must be default constructible.");
+
+        // Defragment once holes exceed live elements and this many elements.
+        static constexpr size_t defragment_threshold = 4096;
+
+        struct Iterator {
+        private:
+            int curIdx;
+            typename super::packed_type* packed;
+            std::vector<instance_type>* slices;
+
+        public:
+            Iterator(typename super::packed_type* _packed, std::vector<instance_type>* _slices, int idx = 0) : curIdx(idx), packed{ _packed }, slices{ _slices } {};
+            Iterator& operator++() {
+                curIdx++;
+                return *this;
+            }
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+            tuple<const Entity, instance_type&> operator*() {
+                return std::tuple_cat(
+                    std::make_tuple((*packed)[curIdx]),
+                    std::forward_as_tuple((*slices)[curIdx])
+                );
+            }
+            bool operator==(const Iterator& rhs) const noexcept {
+                return rhs.curIdx == curIdx && rhs.packed == packed;
+            }
+            bool operator!=(const Iterator& rhs) const noexcept {
+                return !operator==(rhs);
+            }
+        };
+        using iterator = Iterator;
+
+        ArenaComponentPool() = default;
+        // Slices point at the pool's own arena, so a copy re-points them.
+        ArenaComponentPool(const ArenaComponentPool& rhs) : super(rhs), arena{ rhs.arena }, slices{ rhs.slices }, holes{ rhs.holes } {
+            for (auto& slice : slices) slice.arena = &arena;
+        }
+        ArenaComponentPool& operator=(const ArenaComponentPool& rhs) {
+            super::operator=(rhs);
+            arena = rhs.arena;
+            slices = rhs.slices;
+            holes = rhs.holes;
+            for (auto& slice : slices) slice.arena = &arena;
+            return *this;
+        }
+
+        std::tuple<instance_type&> get_as_tuple(const Entity& entt) {
+            return std::forward_as_tuple(get(entt));
+        }
+        std::tuple<instance_type&> get_at_as_tuple(const size_t idx) {
+            return std::forward_as_tuple(slices[idx]);
+        }
+        instance_type& get(const Entity& entt) {
+            return slices[position(entt)];
+        }
+
+        void emplace(const Entity& entt, list_type&& list) {
+            super::emplace(entt);
+            slices.push_back(append(list.begin(), list.end()));
+        }
+        void emplace_n(const Entity* first, const size_t count, const list_type& list) {
+            super::emplace_n(first, count);
+            arena.reserve(arena.size() + count * list.size());
+            for (size_t i = 0; i < count; i++) slices.push_back(append(list.begin(), list.end()));
+        }
+        bool remove(const Entity& entt) override {
+            if (!super::contains(entt)) return false;
+
+            CONTAINER_DEBUG_LOG("Removed from arena pool : " << std::to_string(traits_type::to_entity(entt)));
+
+            const auto idx = position(entt);
+            holes += slices[idx].capacity;
+            super::remove(entt);
+            __internal::relocate_last_into(slices, idx);
+            slices.pop_back();
+            defragment_if_sparse();
+            return true;
+        }
+
+        // Append one element to entt's slice.
+        element_type& push_back(const Entity& entt, element_type value) {
+            auto& slice = get(entt);
+            reserve_slice(slice, slice.length + 1);
+            arena[slice.offset + slice.length] = std::move(value);
+            slice.length++;
+            defragment_if_sparse();
+            return arena[slice.offset + slice.length - 1];
+        }
+        // Remove element i, keeping the order of the rest.
+        void erase(const Entity& entt, const size_t i) {
+            auto& slice = get(entt);
+            std::move(slice.begin() + i + 1, slice.end(), slice.begin() + i);
+            slice.length--;
+        }
+        // Replace entt's elements, reusing its reservation when large enough.
+        void assign(const Entity& entt, const list_type& list) {
+            auto& slice = get(entt);
+            slice.length = 0;
+            reserve_slice(slice, static_cast<typename instance_type::size_type>(list.size()));
+            std::copy(list.begin(), list.end(), arena.begin() + slice.offset);
+            slice.length = static_cast<typename instance_type::size_type>(list.size());
+            defragment_if_sparse();
+        }
+        void clear(const Entity& entt) {
+            get(entt).length = 0;
+        }
+
+        // Repack every slice in packed order, dropping holes and spare reservations.
+        void defragment() {
+            size_t live = 0;
+            for (const auto& slice : slices) live += slice.length;
+
+            arena_type packedArena;
+            packedArena.reserve(live);
+            for (auto& slice : slices) {
+                const auto offset = static_cast<typename instance_type::size_type>(packedArena.size());
+                for (size_t i = 0; i < slice.length; i++) packedArena.push_back(std::move(arena[slice.offset + i]));
+                slice.offset = offset;
+                slice.capacity = slice.length;
+            }
+            using std::swap;
+            swap(arena, packedArena);
+            holes = 0;
+        }
+        // Elements held by the arena, including holes and spare reservations.
+        size_t arena_size() const noexcept {
+            return arena.size();
+        }
+        size_t hole_size() const noexcept {
+            return holes;
+        }
+        void shrink_to_fit() override {
+            super::shrink_to_fit();
+            defragment();
+            arena.shrink_to_fit();
+            slices.shrink_to_fit();
+        }
+
+        iterator begin() {
+            return iterator(&this->packed, &slices, 0);
+        }
+        iterator end() {
+            return iterator(&this->packed, &slices, this->packed.size());
+        }
+
+    private:
+        inline size_t position(const Entity& entt) const {
+            return static_cast<size_t>(traits_type::to_entity(this->sparse_get(entt)));
+        }
+
+        template <typename It>
+        instance_type append(It first, It last) {
+            const auto offset = static_cast<typename instance_type::size_type>(arena.size());
+            for (; first != last; ++first) arena.push_back(*first);
+            return instance_type(&arena, offset, static_cast<typename instance_type::size_type>(arena.size() - offset));
+        }
+
+        void reserve_slice(instance_type& slice, const typename instance_type::size_type required) {
+            if (required <= slice.capacity) return;
+
+            // Last reservation in the arena: extend in place.
+            if (slice.offset + slice.capacity == arena.size()) {
+                arena.resize(slice.offset + required);
+                slice.capacity = required;
+                return;
+            }
+
+            const auto capacity = std::max<typename instance_type::size_type>(required, slice.capacity * 2);
+            const auto offset = static_cast<typename instance_type::size_type>(arena.size());
+            arena.resize(offset + capacity);
+            for (size_t i = 0; i < slice.length; i++) arena[offset + i] = std::move(arena[slice.offset + i]);
+            holes += slice.capacity;
+            slice.offset = offset;
+            slice.capacity = capacity;
+        }
+        void defragment_if_sparse() {
+            if (holes > defragment_threshold && holes * 2 > arena.size()) defragment();
+        }
+
+        arena_type arena;
+        std::vector<instance_type> slices; // parallel to packed
+        size_t holes = 0;
+    };
+
+    /**
+     * @brief Pool for rarely touched components (ContainerType::Cold): values are kept in fixed-size pages
+     * compressed with page_codec.
+     *
+     * Values stay in packed order; page p holds positions [p * page_elements, (p + 1) * page_elements).
+     * Accessing a value decompresses its page into a small LRU of hot pages; a page that was written is
+     * recompressed when it is evicted. References returned by get() stay valid until hot_pages other
+     * pages have been touched. Prefer value() for reads: it does not mark the page for recompression.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
+    class ColdComponentPool : public sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>> {
+    public:
+        using traits_type = LEapsGL::entity_traits<Entity>;
+        using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
+        using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
+        using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
+        using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>, traits::to_sparse_index_t<Type, Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>>;
+        using instance_type = typename traits::to_instance_t<Type>;
+
+        static_assert(std::is_trivially_copyable_v<instance_type>, "Cold components are compressed as bytes and must be trivially copyable.");
+
+        static constexpr size_t page_bytes = 16384;
+        static constexpr size_t page_elements = std::max<size_t>(1, page_bytes / sizeof(instance_type));
+        static constexpr size_t hot_pages = 8;
+
+        struct Iterator {
+        private:
+            int curIdx;
+            ColdComponentPool* pool;
+
+        public:
+            Iterator(ColdComponentPool* _pool, int idx = 0) : curIdx(idx), pool{ _pool } {};
+            Iterator& operator++() {
+                curIdx++;
+                return *this;
+            }
+            Iterator operator++(int) {
+                Iterator tmp = *this;
+                ++(*this);
+                return tmp;
+            }
+            tuple<const Entity, instance_type&> operator*() {
+                return std::tuple_cat(
+                    std::make_tuple(pool->packed[curIdx]),
+                    std::forward_as_tuple(pool->at(curIdx, true))
+                );
+            }
+            bool operator==(const Iterator& rhs) const noexcept {
+                return rhs.curIdx == curIdx && rhs.pool == pool;
+            }
+            bool operator!=(const Iterator& rhs) const noexcept {
+                return !operator==(rhs);
+            }
+        };
+        using iterator = Iterator;
+
+        ColdComponentPool() = default;
+        // Hot slots refer to pages by index, so a member-wise copy is self-contained.
+        ColdComponentPool(const ColdComponentPool&) = default;
+        ColdComponentPool& operator=(const ColdComponentPool&) = default;
+
+        std::tuple<instance_type&> get_as_tuple(const Entity& entt) {
+            return std::forward_as_tuple(get(entt));
+        }
+        std::tuple<instance_type&> get_at_as_tuple(const size_t idx) {
+            return std::forward_as_tuple(at(idx, true));
+        }
+        instance_type& get(const Entity& entt) {
+            return at(position(entt), true);
+        }
+        // Read-only copy; the page is not recompressed on eviction because of this access.
+        instance_type value(const Entity& entt) {
+            return at(position(entt), false);
+        }
+        // Read-only access for views whose callback takes const references (see View::each); the reference
+        // stays valid until hot_pages other pages have been touched.
+        std::tuple<const instance_type&> read_as_tuple(const Entity& entt) {
+            return std::forward_as_tuple(at(position(entt), false));
+        }
+        std::tuple<const instance_type&> read_at_as_tuple(const size_t idx) {
+            return std::forward_as_tuple(at(idx, false));
+        }
+
+        void emplace(const Entity& entt, instance_type&& arg) {
+            const size_t idx = this->packed.size();
+            super::emplace(entt);
+            if (idx % page_elements == 0) pages.emplace_back();
+            at(idx, true) = std::move(arg);
+        }
+        void emplace_n(const Entity* first, const size_t count, const instance_type& value) {
+            const size_t offset = this->packed.size();
+            super::emplace_n(first, count);
+            for (size_t i = 0; i < count; i++) {
+                if ((offset + i) % page_elements == 0) pages.emplace_back();
+                at(offset + i, true) = value;
+            }
+        }
+        bool remove(const Entity& entt) override {
+            if (!super::contains(entt)) return false;
+
+            CONTAINER_DEBUG_LOG("Removed from cold pool : " << std::to_string(traits_type::to_entity(entt)));
+
+            const size_t idx = position(entt);
+            const size_t last = this->packed.size() - 1;
+            if (idx != last) {
+                const instance_type moved = at(last, false);
+                at(idx, true) = moved;
+            }
+            super::remove(entt);
+            if (last % page_elements == 0) drop_last_page();
+            return true;
+        }
+
+        // Recompress every written hot page and release the hot cache.
+        void flush() {
+            for (auto& slot : cache) {
+                if (slot.page == npos) continue;
+                evict(slot);
+            }
+            for (auto& slot : cache) {
+                slot.values.clear();
+                slot.values.shrink_to_fit();
+            }
+        }
+        // Bytes held by compressed pages plus the hot cache.
+        size_t resident_bytes() const noexcept {
+            size_t bytes = 0;
+            for (const auto& page : pages) bytes += page.bytes.capacity();
+            for (const auto& slot : cache) bytes += slot.values.capacity() * sizeof(instance_type);
+            return bytes + pages.capacity() * sizeof(cold_page);
+        }
+        // Bytes the same values take in a plain component array.
+        size_t raw_bytes() const noexcept {
+            return this->packed.size() * sizeof(instance_type);
+        }
+        // Hot pages that will be recompressed when evicted.
+        size_t dirty_pages() const noexcept {
+            return static_cast<size_t>(std::count_if(cache.begin(), cache.end(), [](const hot_slot& slot) { return slot.page != npos && slot.dirty; }));
+        }
+        void shrink_to_fit() override {
+            super::shrink_to_fit();
+            flush();
+            for (auto& page : pages) page.bytes.shrink_to_fit();
+            pages.shrink_to_fit();
+        }
+
+        iterator begin() {
+            return iterator(this, 0);
+        }
+        iterator end() {
+            return iterator(this, this->packed.size());
+        }
+
+    private:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        struct cold_page {
+            std::vector<std::uint8_t> bytes; // compressed page; empty for a page never written back
+            size_t hot = npos;               // cache slot while resident
+        };
+        struct hot_slot {
+            size_t page = npos;
+            std::vector<instance_type> values;
+            bool dirty = false;
+            std::uint64_t stamp = 0;
+        };
+
+        inline size_t position(const Entity& entt) const {
+            return static_cast<size_t>(traits_type::to_entity(this->sparse_get(entt)));
+        }
+
+        instance_type& at(const size_t idx, const bool write) {
+            hot_slot& slot = assure_hot(idx / page_elements);
+            slot.dirty |= write;
+            return slot.values[idx % page_elements];
+        }
+
+        hot_slot& assure_hot(const size_t page) {
+            cold_page& target = pages[page];
+            if (target.hot != npos) {
+                hot_slot& slot = cache[target.hot];
+                slot.stamp = ++clock;
+                return slot;
+            }
+
+            // Least recently used (or unused) slot.
+            size_t victim = 0;
+            for (size_t i = 1; i < hot_pages; i++) {
+                if (cache[i].stamp < cache[victim].stamp) victim = i;
+            }
+            hot_slot& slot = cache[victim];
+            if (slot.page != npos) evict(slot);
+
+            slot.values.resize(page_elements);
+            if (target.bytes.empty()) std::fill(slot.values.begin(), slot.values.end(), instance_type{});
+            else page_codec::decompress(target.bytes.data(), target.bytes.size(), reinterpret_cast<std::uint8_t*>(slot.values.data()), page_elements * sizeof(instance_type));
+
+            slot.page = page;
+            slot.dirty = false;
+            slot.stamp = ++clock;
+            target.hot = victim;
+            return slot;
+        }
+        void evict(hot_slot& slot) {
+            cold_page& page = pages[slot.page];
+            if (slot.dirty) page_codec::compress(reinterpret_cast<const std::uint8_t*>(slot.values.data()), page_elements * sizeof(instance_type), page.bytes);
+            page.hot = npos;
+            slot.page = npos;
+            slot.dirty = false;
+            slot.stamp = 0;
+        }
+        void drop_last_page() {
+            cold_page& page = pages.back();
+            if (page.hot != npos) {
+                hot_slot& slot = cache[page.hot];
+                slot.page = npos;
+                slot.dirty = false;
+                slot.stamp = 0;
+            }
+            pages.pop_back();
+        }
+
+        std::vector<cold_page> pages;
+        std::array<hot_slot, hot_pages> cache;
+        std::uint64_t clock = 0;
+    };
+
+#ifdef LEAPS_MAPPED_FILE_AVAILABLE
+    /**
+     * @brief Default pool whose component array and sparse slots live in memory-mapped files (ContainerType::Mapped).
+     *
+     * For worlds larger than memory: the kernel writes cold pages back to the files and reads them in on
+     * demand. Views call advise_sequential() before a sweep so the component file is read ahead.
+     * The packed entity array stays in ordinary memory because every pool of a view shares its type.
+     */
+    template <typename Type, typename Entity, typename Allocator = std::allocator<typename traits::to_instance_t<Type>>>
+    class MappedComponentPool : public DefaultComponentPool<Type, Entity, Allocator,
+        mapped_vector<traits::to_instance_t<Type>>,
+        mapped_sparse_index<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>> {
+    public:
+        // Linear read-ahead over the component file, plus an explicit fetch of the first window.
+        void advise_sequential() const noexcept {
+            this->components.advise_sequential();
+            this->components.advise_willneed(0, readahead_elements());
+        }
+        // Start reading [first, first + count) in the background.
+        void advise_willneed(const size_t first, const size_t count) const noexcept {
+            this->components.advise_willneed(first, count);
+        }
+
+    private:
+        static constexpr size_t readahead_bytes = size_t{ 8 } << 20;
+        static constexpr size_t readahead_elements() noexcept {
+            return std::max<size_t>(1, readahead_bytes / sizeof(traits::to_instance_t<Type>));
+        }
+    };
+#endif
+
+    namespace __internal {
+        template <typename Pool, typename = void>
+        struct is_unique_pool : std::false_type {};
+
+        template <typename Pool>
+        struct is_unique_pool<Pool, std::enable_if_t<Pool::is_unique>> : std::true_type {};
+
+        template <typename Pool, typename = void>
+        struct is_indexed_pool : std::false_type {};
+
+        template <typename Pool>
+        struct is_indexed_pool<Pool, std::enable_if_t<Pool::is_indexed>> : std::true_type {};
+
+        template <typename Pool, typename = void>
+        struct is_tracked_pool : std::false_type {};
+
+        template <typename Pool>
+        struct is_tracked_pool<Pool, std::enable_if_t<Pool::is_tracked>> : std::true_type {};
+
+        template <typename Pool, typename = void>
+        struct has_prefetch_sparse : std::false_type {};
+
+        template <typename Pool>
+        struct has_prefetch_sparse<Pool, std::void_t<decltype(std::declval<const Pool&>().prefetch_sparse(std::declval<const typename Pool::value_type&>()))>> : std::true_type {};
+
+        // Pools whose membership can be resolved to a packed position (and read back by position).
+        template <typename Pool, typename = void>
+        struct has_packed_index : std::false_type {};
+
+        template <typename Pool>
+        struct has_packed_index<Pool, std::void_t<decltype(std::declval<const Pool&>().packed_index(std::declval<const typename Pool::value_type&>()))>> : std::true_type {};
+
+        template <typename Pool, typename = void>
+        struct has_get_at : std::false_type {};
+
+        template <typename Pool>
+        struct has_get_at<Pool, std::void_t<decltype(std::declval<Pool&>().get_at_as_tuple(size_t{}))>> : std::true_type {};
+
+        template <typename Pool, typename = void>
+        struct has_advise_sequential : std::false_type {};
+
+        template <typename Pool>
+        struct has_advise_sequential<Pool, std::void_t<decltype(std::declval<const Pool&>().advise_sequential())>> : std::true_type {};
+
+        template <typename Pool>
+        inline void advise_sequential(const Pool* pool) {
+            if constexpr (has_advise_sequential<Pool>::value) pool->advise_sequential();
+        }
+        template <typename Pool, typename Entity>
+        inline void prefetch_sparse(const Pool* pool, const Entity& entt) {
+            if constexpr (has_prefetch_sparse<Pool>::value) pool->prefetch_sparse(entt);
+        }
+        // Position of entt in pool (prefetching its row), or size_t(-1) when it cannot be resolved.
+        template <typename Pool, typename Entity>
+        inline size_t resolve_row(const Pool* pool, const Entity& entt) {
+            if constexpr (has_packed_index<Pool>::value) {
+                const size_t idx = pool->packed_index(entt);
+                if (idx < pool->size()) pool->prefetch_at(idx);
+                return idx;
+            }
+            else return static_cast<size_t>(-1);
+        }
+        template <typename Pool, typename Entity>
+        inline bool contains_at(const Pool* pool, const Entity& entt, const size_t idx) {
+            if constexpr (is_unique_pool<Pool>::value) return true;
+            else if constexpr (has_packed_index<Pool>::value) return idx < pool->size() && pool->packed[idx] == entt;
+            else return pool->contains(entt);
+        }
+
+        // Callable with a single, non-template operator() (a lambda without auto parameters).
+        template <typename Fun, typename = void>
+        struct has_plain_call : std::false_type {};
+
+        template <typename Fun>
+        struct has_plain_call<Fun, std::void_t<decltype(&Fun::operator())>> : std::true_type {};
+
+        // Pools whose mutable accessors record a write (ColdComponentPool) also offer read_as_tuple / read_at_as_tuple.
+        template <typename Pool, typename = void>
+        struct has_read_access : std::false_type {};
+
+        template <typename Pool>
+        struct has_read_access<Pool, std::void_t<decltype(std::declval<Pool&>().read_at_as_tuple(size_t{}))>> : std::true_type {};
+
+        template <typename Pool, typename Entity>
+        inline decltype(auto) read_as_tuple(Pool* pool, const Entity& entt) {
+            if constexpr (has_read_access<Pool>::value) return pool->read_as_tuple(entt);
+            else return pool->get_as_tuple(entt);
+        }
+        template <typename Pool, typename Entity>
+        inline decltype(auto) read_at_as_tuple(Pool* pool, const Entity& entt, const size_t idx) {
+            if constexpr (has_read_access<Pool>::value) return pool->read_at_as_tuple(idx);
+            else if constexpr (has_get_at<Pool>::value) return pool->get_at_as_tuple(idx);
+            else return pool->get_as_tuple(entt);
+        }
+    }
+
+    //
+    //template <typename Entity, typename Value, typename GetHash, typename GetEqual>
+    //class ContextContainer : public ContainerBase <Entity> {
+    //    using traits_type = LEapsGL::entity_traits<Entity>;
+    //    using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
+    //    using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
+    //    using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
+    //    using super = sparse_array<Entity, typename std::allocator_traits<Allocator>::template rebind_alloc<Entity>>;
+
+    //private:       
+    //    std::unordered_map<Entity, Value, GetHash, GetEqual> context;
+    //};
+
+    //template<typename Type, typename Entity = LEapsGL::entity, typename Allocator = std::allocator<std::remove_const_t<Type>>>
+    //struct component_pool_for {
+    //    /*! @brief Type-to-storage conversion result. */
+    //    using type = constness_as_t<storage_type_t<std::remove_const_t<Type>, Entity, Allocator>, Type>;
+    //};
+    //
+    //template<typename Type>
+    //using component_pool_for_type = typename component_pool_for<Type, Entity, typename alloc_traits::template rebind_alloc<std::remove_const_t<Type>>>::type;
+
+
+    template<typename T, typename Tuple>
+    struct type_index;
+
+
+    template <typename T, typename... Others>
+    struct type_index<T, std::tuple<T, Others...>> {
+        static constexpr size_t value = 0;
+    };
+
+    template <typename T, typename U, typename... Others>
+    struct type_index<T, std::tuple<U, Others...>> {
+        static constexpr size_t value = 1 + type_index<T, std::tuple<Others...>>::value;
+    };
+
+
+    template <typename ... ComponentPoolTypes>
+    struct W_ComponentPool {};
+
+    template <typename ... FilterPools>
+    struct Filter {};
+
+    // View option: also visit entities disabled with World::disable().
+    struct IncludeDisabled {};
+
+    template <typename...>
+    class View;
+
+    template <typename... ComponentPoolTypes, typename... Filters>
+    class View<W_ComponentPool<ComponentPoolTypes...>, Filter<Filters...>>{
+    private:
+        using Entity = std::common_type_t<typename ComponentPoolTypes::value_type...>;
+        using super_type = std::common_type_t<typename ComponentPoolTypes::packed_base...>;
+
+        using value_type = typename LEapsGL::entity_traits<Entity>::value_type;
+        using entity_type = typename LEapsGL::entity_traits<Entity>::entity_type;
+        using version_type = typename LEapsGL::entity_traits<Entity>::version_type;
+        using traits_type = LEapsGL::entity_traits<Entity>;
+
+        template<typename T>
         static constexpr std::size_t index_of = type_index<T, std::tuple <typename ComponentPoolTypes::instance_type...>>::value;
 
+        // Unique pools are bound to every entity instead of being probed.
+        static constexpr bool all_unique = (__internal::is_unique_pool<ComponentPoolTypes>::value && ...);
+
         // The set with the smallest element
         const super_type* view;
+        template <typename Pool>
+        void pickSmaller(const Pool* pool) noexcept {
+            if constexpr (!__internal::is_unique_pool<Pool>::value || all_unique) {
+                if (!this->view || pool->size() < this->view->size()) this->view = pool;
+            }
+        }
         void setSmallestComponentPoolPointer() noexcept {
-            view = std::get<0>(containers_);
-            std::apply([this](auto *...components) {((this->view = components->size() < this->view->size() ? components : this->view), ...); }, containers_);
-            if constexpr (sizeof...(Filters) > 0) std::apply([this](auto *...filters) {((this->view = filters->size() < this->view->size() ? filters : this->view), ...); }, filters_); 
+            view = nullptr;
+            std::apply([this](auto *...components) {(this->pickSmaller(components), ...); }, containers_);
+            if constexpr (sizeof...(Filters) > 0) std::apply([this](auto *...filters) {(this->pickSmaller(filters), ...); }, filters_);
+        }
+        // File-backed pools start reading ahead before a sweep.
+        void adviseSequential() const noexcept {
+            std::apply([](auto *...components) { (__internal::advise_sequential(components), ...); }, containers_);
+        }
+        bool boundResourcesReady() const noexcept {
+            return std::apply([](auto *...components) { return (View::isReady(components) && ...); }, containers_);
+        }
+        template <typename Pool>
+        static bool isReady(const Pool* pool) noexcept {
+            if constexpr (__internal::is_unique_pool<Pool>::value) return pool->has_value();
+            else return true;
+        }
+
+        template <std::size_t Index>
+        bool probe(const Entity& entt) const {
+            using pool_type = std::tuple_element_t<Index, std::tuple<ComponentPoolTypes...>>;
+            if constexpr (__internal::is_unique_pool<pool_type>::value) return true;
+            else return std::get<Index>(containers_)->contains(entt);
         }
 
         template<std::size_t ... Index>
@@ -607,14 +2028,68 @@ namespace LEapsGL{
             setSmallestComponentPoolPointer();
         }
 
+        // Entities marked in disabled are skipped (World passes its disabled set unless IncludeDisabled is given).
+        View& skip(const entity_bitset<Entity>* disabled) noexcept {
+            this->disabled_ = disabled;
+            return *this;
+        }
+        inline bool enabled(const Entity& entt) const noexcept {
+            return !disabled_ || !disabled_->test(entt);
+        }
+
         template <typename T, typename... Others>
         decltype(auto) get(const Entity& entt) {
             return get<index_of<T>, index_of<Others>...>(entt);
         }
 
+        /*
+            A callback taking its components by const reference (or by value) only reads them; pools that
+            record writes through their mutable accessors (ColdComponentPool) are then read without
+            marking anything for write-back. Generic lambdas always take the mutable path.
+        */
         template <typename Fun>
         void each(Fun fn) {
-            this->view ? this->pick_and_each(fn, std::index_sequence_for<ComponentPoolTypes...>{}, std::index_sequence_for<Filters...>{}) : void();
+            this->adviseSequential();
+            if constexpr (View::reads_only<Fun>()) {
+                if (this->view && this->boundResourcesReady()) this->pick_and_read(fn, std::index_sequence_for<ComponentPoolTypes...>{}, std::index_sequence_for<Filters...>{});
+            }
+            else {
+                this->view && this->boundResourcesReady() ? this->pick_and_each(fn, std::index_sequence_for<ComponentPoolTypes...>{}, std::index_sequence_for<Filters...>{}) : void();
+            }
+        }
+
+        // Generic callbacks are never probed: checking them against const arguments would instantiate their bodies.
+        template <typename Fun>
+        static constexpr bool reads_only() {
+            if constexpr (!(__internal::has_read_access<ComponentPoolTypes>::value || ...) || !__internal::has_plain_call<Fun>::value) return false;
+            else return std::is_invocable_v<Fun&, const typename ComponentPoolTypes::instance_type&...>
+                || std::is_invocable_v<Fun&, const Entity&, const typename ComponentPoolTypes::instance_type&...>;
+        }
+
+        template <typename Fun, std::size_t... Index, std::size_t... FilterIndex>
+        void pick_and_read(Fun& fn, std::index_sequence<Index...> sequence, std::index_sequence<FilterIndex...> filter_sequence) const {
+            ((this->view == std::get<Index>(containers_) ? this->read<Index, true>(fn, sequence, filter_sequence) : void()), ...);
+            ((this->view == std::get<FilterIndex>(filters_) ? this->read<FilterIndex, false>(fn, sequence, filter_sequence) : void()), ...);
+        }
+
+        // each() over the driving pool's packed array, fetching every component through its read accessor.
+        template <std::size_t BaseIndex, bool IS_COMPONENT_VIEW, typename Fun, std::size_t... Index, std::size_t... FilterIndex>
+        void read(Fun& fn, std::index_sequence<Index...>, std::index_sequence<FilterIndex...>) const {
+            const auto& packed = [this]() -> const auto& {
+                if constexpr (IS_COMPONENT_VIEW) return std::get<BaseIndex>(containers_)->packed;
+                else return std::get<BaseIndex>(filters_)->packed;
+            }();
+            for (size_t row = 0; row < packed.size(); row++) {
+                const Entity entt = packed[row];
+                if (!(this->enabled(entt) && (((IS_COMPONENT_VIEW && BaseIndex == Index) || this->template probe<Index>(entt)) && ...)
+                    && (((!IS_COMPONENT_VIEW && BaseIndex == FilterIndex) || std::get<FilterIndex>(filters_)->contains(entt)) && ...))) continue;
+
+                auto components = std::tuple_cat((IS_COMPONENT_VIEW && BaseIndex == Index
+                    ? __internal::read_at_as_tuple(std::get<Index>(containers_), entt, row)
+                    : __internal::read_as_tuple(std::get<Index>(containers_), entt))...);
+                if constexpr (std::is_invocable_v<Fun&, const typename ComponentPoolTypes::instance_type&...>) std::apply(fn, components);
+                else std::apply(fn, std::tuple_cat(std::forward_as_tuple(entt), components));
+            }
         }
 
         template <typename Fun, std::size_t... Index, std::size_t... FilterIndex>
@@ -624,6 +2099,119 @@ namespace LEapsGL{
         }
 
 
+        /**
+         * @brief Iterates the view driven by the shared pool of T, grouped by shared value.
+         *
+         * on_group(const value&) is called before the first entity of every run of equal values,
+         * then fn is invoked per entity exactly as in each(). Intended for batching draw submission.
+         */
+        template <typename T, typename GroupFun, typename Fun>
+        void each_group(GroupFun on_group, Fun fn) {
+            if (!this->boundResourcesReady()) return;
+            constexpr std::size_t BaseIndex = type_index<SharedComponentPool<T, Entity>, std::tuple<ComponentPoolTypes...>>::value;
+            std::get<BaseIndex>(containers_)->sort_by_value();
+            this->each_group<BaseIndex>(on_group, fn, std::index_sequence_for<ComponentPoolTypes...>{}, std::index_sequence_for<Filters...>{});
+        }
+
+        template <std::size_t BaseIndex, typename GroupFun, typename Fun, std::size_t... Index, std::size_t... FilterIndex>
+        void each_group(GroupFun& on_group, Fun& fn, std::index_sequence<Index...>, std::index_sequence<FilterIndex...>) const {
+            const void* current = nullptr;
+            for (const auto items : *std::get<BaseIndex>(containers_)) {
+                if (const auto entt = std::get<0>(items); this->enabled(entt) && ((BaseIndex == Index || this->template probe<Index>(entt)) && ...) && (std::get<FilterIndex>(filters_)->contains(entt) && ...)) {
+                    if (const void* shared = &std::get<1>(items); shared != current) {
+                        on_group(std::get<1>(items));
+                        current = shared;
+                    }
+                    if constexpr (std::is_invocable_v<decltype(fn)&, typename ComponentPoolTypes::instance_type&...>) {
+                        std::apply(fn, std::tuple_cat(this->dispatch_get<BaseIndex, Index>(items)...));
+                    }
+                    else {
+                        std::apply(fn, std::tuple_cat(std::forward_as_tuple(entt), this->dispatch_get<BaseIndex, Index>(items)...));
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief each() with a software-pipelined join, for pools whose orders have diverged.
+         *
+         * The driving pool is walked in blocks of Lookahead entities. For each block the sparse slots of the
+         * other pools are prefetched first; the second pass reads those slots, keeps the packed position of every
+         * entity and prefetches its packed entry and component row; the last pass checks membership against the
+         * kept positions and reads components by position. The dependent misses of a block overlap instead of
+         * serialising per entity, and each sparse slot is read once. Falls back to each() when a filter drives the view.
+         */
+        template <std::size_t Lookahead = 32, typename Fun>
+        void each_prefetched(Fun fn) {
+            static_assert(Lookahead > 0, "Lookahead must be positive.");
+            if constexpr (View::reads_only<Fun>()) return this->each(fn); // compressed pools gain nothing from prefetching
+            if (!this->view || !this->boundResourcesReady()) return;
+            this->adviseSequential();
+            this->pick_and_each_prefetched<Lookahead>(fn, std::index_sequence_for<ComponentPoolTypes...>{}, std::index_sequence_for<Filters...>{});
+        }
+
+        template <std::size_t Lookahead, typename Fun, std::size_t... Index, std::size_t... FilterIndex>
+        void pick_and_each_prefetched(Fun& fn, std::index_sequence<Index...> sequence, std::index_sequence<FilterIndex...> filter_sequence) const {
+            ((this->view == std::get<Index>(containers_) ? this->each_prefetched<Index, Lookahead>(fn, sequence, filter_sequence) : void()), ...);
+            ((this->view == std::get<FilterIndex>(filters_) ? this->each<FilterIndex, false>(fn, sequence, filter_sequence) : void()), ...);
+        }
+
+        template <std::size_t BaseIndex, std::size_t Lookahead, typename Fun, std::size_t... Index, std::size_t... FilterIndex>
+        void each_prefetched(Fun& fn, std::index_sequence<Index...>, std::index_sequence<FilterIndex...>) const {
+            constexpr std::size_t filter_offset = sizeof...(ComponentPoolTypes);
+            auto& base = *std::get<BaseIndex>(containers_);
+            const auto& packed = base.packed;
+            const size_t total = packed.size();
+
+            // rows[pool][i]: packed position of the i-th entity of the block in that pool
+            std::array<std::array<size_t, Lookahead>, sizeof...(ComponentPoolTypes) + sizeof...(Filters)> rows;
+            auto cursor = base.begin();
+            for (size_t first = 0; first < total; first += Lookahead) {
+                const size_t count = std::min(Lookahead, total - first);
+
+                // 1) sparse slots of the probed pools
+                for (size_t i = 0; i < count; i++) {
+                    const Entity entt = packed[first + i];
+                    ((BaseIndex == Index ? void() : __internal::prefetch_sparse(std::get<Index>(containers_), entt)), ...);
+                    (__internal::prefetch_sparse(std::get<FilterIndex>(filters_), entt), ...);
+                }
+                // 2) positions, with their packed entries and component rows prefetched
+                for (size_t i = 0; i < count; i++) {
+                    const Entity entt = packed[first + i];
+                    ((rows[Index][i] = BaseIndex == Index ? first + i : __internal::resolve_row(std::get<Index>(containers_), entt)), ...);
+                    ((rows[filter_offset + FilterIndex][i] = __internal::resolve_row(std::get<FilterIndex>(filters_), entt)), ...);
+                }
+                // 3) membership and callbacks
+                for (size_t i = 0; i < count; i++, ++cursor) {
+                    const auto items = *cursor;
+                    const Entity entt = std::get<0>(items);
+                    if (!(this->enabled(entt) && ((BaseIndex == Index || __internal::contains_at(std::get<Index>(containers_), entt, rows[Index][i])) && ...)
+                        && (__internal::contains_at(std::get<FilterIndex>(filters_), entt, rows[filter_offset + FilterIndex][i]) && ...))) continue;
+
+                    if constexpr (std::is_invocable_v<decltype(fn)&, typename ComponentPoolTypes::instance_type&...>) {
+                        std::apply(fn, std::tuple_cat(this->dispatch_get_at<BaseIndex, Index>(items, rows[Index][i])...));
+                    }
+                    else {
+                        std::apply(fn, std::tuple_cat(std::forward_as_tuple(entt), this->dispatch_get_at<BaseIndex, Index>(items, rows[Index][i])...));
+                    }
+                }
+            }
+        }
+
+        template<std::size_t BaseIndex, std::size_t Others, typename Items>
+        auto dispatch_get_at(const Items& items, const size_t row) const {
+            using pool_type = std::tuple_element_t<Others, std::tuple<ComponentPoolTypes...>>;
+            if constexpr (Others == BaseIndex) {
+                return this->dispatch_get<BaseIndex, Others>(items);
+            }
+            else if constexpr (__internal::has_get_at<pool_type>::value) {
+                return std::get<Others>(containers_)->get_at_as_tuple(row);
+            }
+            else {
+                return std::get<Others>(containers_)->get_as_tuple(std::get<0>(items));
+            }
+        }
+
         template<std::size_t BaseIndex, std::size_t Others, typename... Args>
         auto dispatch_get(const std::tuple<const entity_type, Args...>& items) const {
             if constexpr (Others == BaseIndex) {
@@ -638,8 +2226,8 @@ namespace LEapsGL{
         void each(Fun fn, std::index_sequence<Index...>, std::index_sequence<FilterIndex...>) const {
             if constexpr (IS_COMPONENT_VIEW) {
                 for (const auto items : *std::get<BaseIndex>(containers_)) {
-                    if (const auto entt = std::get<0>(items); ((BaseIndex == Index || std::get<Index>(containers_)->contains(entt)) && ...) && (std::get<FilterIndex>(filters_)->contains(entt) && ...)) {
-                        if constexpr (std::is_invocable<decltype(fn), std::add_lvalue_reference<ComponentPoolTypes::instance_type>::type...>::value) {
+                    if (const auto entt = std::get<0>(items); this->enabled(entt) && ((BaseIndex == Index || this->template probe<Index>(entt)) && ...) && (std::get<FilterIndex>(filters_)->contains(entt) && ...)) {
+                        if constexpr (std::is_invocable_v<decltype(fn)&, typename ComponentPoolTypes::instance_type&...>) {
                             std::apply(fn, std::tuple_cat(this->dispatch_get<BaseIndex, Index>(items)...));
                         }
                         else {
@@ -650,8 +2238,8 @@ namespace LEapsGL{
             }
             else {
                 for (const auto items : *std::get<BaseIndex>(filters_)) {
-                    if (const auto entt = std::get<0>(items); ((std::get<Index>(containers_)->contains(entt)) && ...) && ((BaseIndex == FilterIndex || std::get<FilterIndex>(filters_)->contains(entt)) && ...)) {
-                        if constexpr (std::is_invocable<decltype(fn), std::add_lvalue_reference<ComponentPoolTypes::instance_type>::type...>::value) {
+                    if (const auto entt = std::get<0>(items); this->enabled(entt) && (this->template probe<Index>(entt) && ...) && ((BaseIndex == FilterIndex || std::get<FilterIndex>(filters_)->contains(entt)) && ...)) {
+                        if constexpr (std::is_invocable_v<decltype(fn)&, typename ComponentPoolTypes::instance_type&...>) {
                             std::apply(fn, std::tuple_cat(this->dispatch_get<sizeof...(Index), Index>(items)...));
                         }
                         else {
@@ -669,7 +2257,7 @@ namespace LEapsGL{
 
             template <std::size_t... Index>
             bool checkAlltypeContains(const Entity& entt, std::index_sequence<Index...>) const {
-                return (std::get<Index>(container->containers_)->contains(entt) && ...);
+                return container->enabled(entt) && (container->template probe<Index>(entt) && ...);
             }
             ViewConstIterator() :container{}, iter{} {};
             ViewConstIterator(View* _view, const_entity_iterator _iter) : container(_view), iter(_iter) {
@@ -707,6 +2295,65 @@ namespace LEapsGL{
     private:
         std::tuple<ComponentPoolTypes*...> containers_;
         std::tuple<Filters*...> filters_;
+        const entity_bitset<Entity>* disabled_ = nullptr;
+    };
+
+    /**
+     * @brief Read-only, densely packed snapshot of a query over a frozen world.
+     *
+     * Matching entities are renumbered 0..size()-1 and every component is copied into its own
+     * contiguous array in that order, so each() is a linear walk with no sparse lookups or membership tests.
+     * The snapshot is built once by World::frozen<Types...>() and dropped by World::unfreeze().
+     */
+    template <typename Entity, typename... Types>
+    class FrozenView {
+        template<typename T>
+        static constexpr std::size_t index_of = type_index<T, std::tuple<Types...>>::value;
+
+    public:
+        template <typename... Pools>
+        FrozenView(std::vector<Entity>&& matched, Pools*... pools) : entities(std::move(matched)) {
+            std::apply([this](auto&... columns) { (columns.reserve(entities.size()), ...); }, columns_);
+            for (const auto& entt : entities) this->copy_row(entt, std::index_sequence_for<Types...>{}, pools...);
+        }
+
+        size_t size() const noexcept {
+            return entities.size();
+        }
+        // Dense index -> original entity handle.
+        const Entity& entity(const size_t idx) const {
+            return entities[idx];
+        }
+        template <typename T>
+        const traits::to_instance_t<T>& get(const size_t idx) const {
+            return std::get<index_of<T>>(columns_)[idx];
+        }
+        // Contiguous column of T, e.g. for culling or a bulk GPU upload.
+        template <typename T>
+        const traits::to_instance_t<T>* data() const noexcept {
+            return std::get<index_of<T>>(columns_).data();
+        }
+
+        template <typename Fun>
+        void each(Fun fn) const {
+            this->each(fn, std::index_sequence_for<Types...>{});
+        }
+
+    private:
+        template <std::size_t... Index, typename... Pools>
+        void copy_row(const Entity& entt, std::index_sequence<Index...>, Pools*... pools) {
+            (std::get<Index>(columns_).push_back(std::get<0>(__internal::read_as_tuple(pools, entt))), ...);
+        }
+        template <typename Fun, std::size_t... Index>
+        void each(Fun& fn, std::index_sequence<Index...>) const {
+            for (size_t i = 0; i < entities.size(); i++) {
+                if constexpr (std::is_invocable_v<Fun&, const traits::to_instance_t<Types>&...>) fn(std::get<Index>(columns_)[i]...);
+                else fn(entities[i], std::get<Index>(columns_)[i]...);
+            }
+        }
+
+        std::vector<Entity> entities;
+        std::tuple<traits::to_component_storage_t<traits::to_instance_t<Types>>...> columns_;
     };
 
     enum class ComponentPoolType {
@@ -757,23 +2404,24 @@ namespace LEapsGL{
             static constexpr ComponentPoolType COMPONENT_POOL_TYPE = opt;
         };
 
-        template<typename Type, typename Entity>
-        struct OptionSelector<ComponentPoolType, Type, Entity> {
-            static constexpr ComponentPoolType value = LEapsGL::__internal::template __component_pool_select_handler<Type>::value;
-            using selector = typename __internal::ComponentPoolSelector<value, Type, Entity>;
+    };
 
-            using BaseType = ContainerBase<Entity>;
-            using DerivedType = typename selector::type;
+    template<typename Type, typename Entity>
+    struct OptionSelector<ComponentPoolType, Type, Entity> {
+        static constexpr ComponentPoolType value = LEapsGL::__internal::template __component_pool_select_handler<Type>::value;
+        using selector = typename __internal::ComponentPoolSelector<value, Type, Entity>;
 
-            // ---------------------------------------- interface
-            [[nodiscard]] static constexpr std::shared_ptr<BaseType> CreateShared() noexcept {
-                return std::make_shared<DerivedType>();
-            }
-            [[nodiscard]] static constexpr decltype(auto) ToComponentPool(const std::shared_ptr<BaseType>& ptr) noexcept {
-                return static_cast<DerivedType*>(ptr.get());
-            }
-        };
-    }
+        using BaseType = ContainerBase<Entity>;
+        using DerivedType = typename selector::type;
+
+        // ---------------------------------------- interface
+        [[nodiscard]] static constexpr std::shared_ptr<BaseType> CreateShared() noexcept {
+            return std::make_shared<DerivedType>();
+        }
+        [[nodiscard]] static constexpr decltype(auto) ToComponentPool(const std::shared_ptr<BaseType>& ptr) noexcept {
+            return static_cast<DerivedType*>(ptr.get());
+        }
+    };
 
     struct BaseDispatcher {
         virtual ~BaseDispatcher() {};
@@ -806,6 +2454,15 @@ namespace LEapsGL{
                 q.pop();
             }
         }
+        // Append this queue's Tag events to other's, keeping their order.
+        template <typename Tag>
+        void moveAll(EventQueue& other) {
+            auto& q = std::get<index_of<Tag>>(queues);
+            while (!q.empty()) {
+                other.template emplace<Tag>(std::move(q.front()));
+                q.pop();
+            }
+        }
     private:
         std::tuple<first_elem<std::queue<DispatchPtr>, DispatchTag>...> queues;
     };
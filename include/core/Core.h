@@ -2,6 +2,9 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 #include <core/CoreSetting.h>
 #include <core/entity.h>
 #include <core/Container.h>
@@ -66,7 +69,10 @@ namespace LEapsGL {
     // SubContext must always have a primary key and temperal entity.
     // It must be possible to create a temperal entity using the primary key.
     // You should be able to obtain the desired pointer component using the temperal entity.
-    class IContext {};
+    class IContext {
+    public:
+        virtual ~IContext() = default;
+    };
 
     /*
     For global context (e.g., ShaderManager, SoundManager...)
@@ -79,12 +85,48 @@ namespace LEapsGL {
             constexpr size_t id = get_type_hash<CTX>();
             auto& ctx = Context::get_instance();
             auto iter = ctx.M.find(id);
-            if (iter == ctx.M.end()) iter = ctx.M.emplace(id, new CTX{}).first;
+            if (iter == ctx.M.end()) {
+                iter = ctx.M.emplace(id, new CTX{}).first;
+                ctx.owned.push_back(iter->second);
+            }
             return *static_cast<CTX*>(iter->second);
         }
+
+        // The context bound to the calling thread (see Scope), otherwise the process-wide one.
+        static Context& get_instance() {
+            return current ? *current : Singleton<Context>::get_instance();
+        }
+        // A separate set of context objects (one per Universe instance, see Universe::CreateInstance).
+        static std::unique_ptr<Context> CreateInstance() {
+            return std::unique_ptr<Context>(new Context());
+        }
+
+        /*
+            Binds a context to the calling thread until the scope ends (nullptr: the process-wide context).
+            Scopes nest; each restores the binding it replaced.
+        */
+        class Scope {
+        public:
+            explicit Scope(Context* ctx) noexcept : previous(std::exchange(current, ctx)) {};
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            ~Scope() {
+                current = previous;
+            }
+        private:
+            Context* previous;
+        };
+
+        ~Context() {
+            for (auto iter = owned.rbegin(); iter != owned.rend(); ++iter) delete *iter;
+        }
+
         std::unordered_map<size_t, IContext*> M;
     protected:
         Context() {};
+    private:
+        std::vector<IContext*> owned; // in creation order, destroyed in reverse
+        static inline thread_local Context* current = nullptr;
     };
 };
 
@@ -23,12 +23,13 @@ namespace LEapsGL{
     */
     constexpr size_t PAGE_SIZE = 4096;
     using BaseEntityType = uint64_t; // Base entity type
+    using CompactEntityType = uint32_t; // 20-bit id, 12-bit version (max 1M entities per world)
     
     /*
         Proxy
     */
-    constexpr size_t PROXY_SEED = 18446744073709551557;
-    constexpr size_t HASH_RANDOM_SEED = 18446744073709551609;
+    constexpr size_t PROXY_SEED = 18446744073709551557ull;
+    constexpr size_t HASH_RANDOM_SEED = 18446744073709551609ull;
 
     /*
         Type
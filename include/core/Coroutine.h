@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define LEAPS_COROUTINES_AVAILABLE
+#endif
+
+#ifdef LEAPS_COROUTINES_AVAILABLE
+namespace LEapsGL {
+
+    /**
+     * @brief Multi-frame system work written as a C++20 coroutine.
+     *
+     * A function returning Coroutine may co_await the Universe awaitables (NextFrame, WaitFrames, WaitFor,
+     * WaitEvent, Async). It does not run until handed to Universe::StartCoroutine, which runs it up to its
+     * first suspension; from then on Universe::Update / Frame resume it once the awaited condition is met.
+     * An exception escaping the body is rethrown from the Update that resumed it.
+     *
+     * Example usage:
+     * \code
+     * LEapsGL::Coroutine StreamChunks(std::vector<Chunk> chunks) {
+     *     for (auto& chunk : chunks) {
+     *         auto mesh = co_await LEapsGL::Universe::Async([&chunk] { return chunk.decode(); });
+     *         upload(mesh);
+     *         co_await LEapsGL::Universe::NextFrame();
+     *     }
+     * }
+     * LEapsGL::Universe::StartCoroutine(StreamChunks(std::move(chunks)));
+     * \endcode
+     */
+    class Coroutine {
+    public:
+        struct promise_type {
+            std::uint64_t id = 0;
+            std::exception_ptr error;
+
+            Coroutine get_return_object() noexcept {
+                return Coroutine(handle_type::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+            // Kept alive at the end so the Universe can read error before destroying the frame.
+            std::suspend_always final_suspend() noexcept {
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept {
+                error = std::current_exception();
+            }
+        };
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        Coroutine(Coroutine&& rhs) noexcept : handle(std::exchange(rhs.handle, nullptr)) {};
+        Coroutine& operator=(Coroutine&& rhs) noexcept {
+            if (this != &rhs) {
+                if (handle) handle.destroy();
+                handle = std::exchange(rhs.handle, nullptr);
+            }
+            return *this;
+        }
+        Coroutine(const Coroutine&) = delete;
+        Coroutine& operator=(const Coroutine&) = delete;
+        ~Coroutine() {
+            if (handle) handle.destroy();
+        }
+
+        // Hand the frame over to its new owner (Universe::StartCoroutine).
+        handle_type release() noexcept {
+            return std::exchange(handle, nullptr);
+        }
+
+    private:
+        explicit Coroutine(const handle_type h) noexcept : handle(h) {};
+        handle_type handle;
+    };
+
+    // Identifies a started coroutine; stays valid (and harmless) after the coroutine finished.
+    struct CoroutineHandle {
+        std::uint64_t id = 0;
+    };
+}
+#endif
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <core/SparseIndex.h>
+
+namespace LEapsGL {
+
+    namespace __internal {
+        // log2 of the largest power of two not above max(1, Bytes / Size).
+        constexpr size_t cow_page_shift(const size_t bytes, const size_t size) noexcept {
+            size_t elements = std::max<size_t>(1, bytes / size);
+            size_t shift = 0;
+            while ((size_t{ 2 } << shift) <= elements) shift++;
+            return shift;
+        }
+    }
+
+    /**
+     * @brief Paged array whose pages are shared between copies until one of them writes.
+     *
+     * Copying the vector copies only the page table. A mutable access to an element (operator[],
+     * back, emplace_back into a shared tail page) first clones its page if another copy still holds it, so a
+     * copy costs memory only for the pages it touches. Const access never clones.
+     */
+    template <typename T>
+    class cow_vector {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "cow_vector requires a trivially copyable, default constructible type.");
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        static constexpr size_t page_shift = __internal::cow_page_shift(4096, sizeof(T));
+        static constexpr size_t page_elements = size_t{ 1 } << page_shift;
+        static constexpr size_t page_mask = page_elements - 1;
+
+        // Position-only iterator, enough for insert(end(), ...).
+        struct iterator {
+            size_type index;
+            bool operator==(const iterator& rhs) const noexcept { return index == rhs.index; }
+            bool operator!=(const iterator& rhs) const noexcept { return index != rhs.index; }
+        };
+
+        T& operator[](const size_type i) {
+            return writable(i >> page_shift).values[i & page_mask];
+        }
+        const T& operator[](const size_type i) const noexcept {
+            return pages[i >> page_shift]->values[i & page_mask];
+        }
+        T& back() {
+            return (*this)[count - 1];
+        }
+        const T& back() const noexcept {
+            return (*this)[count - 1];
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            const T value(std::forward<Args>(args)...);
+            if ((count & page_mask) == 0 && (count >> page_shift) == pages.size()) pages.push_back(std::make_shared<page>());
+            T& slot = (*this)[count++];
+            slot = value;
+            return slot;
+        }
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+        void pop_back() {
+            --count;
+            if ((count & page_mask) == 0) pages.resize(count >> page_shift);
+        }
+        // Appends only: pos must be end().
+        iterator insert(const iterator pos, const size_type n, const T& value) {
+            const T copy = value;
+            for (size_type i = 0; i < n; i++) emplace_back(copy);
+            return pos;
+        }
+        void reserve(const size_type n) {
+            pages.reserve((n + page_mask) >> page_shift);
+        }
+        void resize(const size_type n, const T& value = T{}) {
+            while (count > n) pop_back();
+            while (count < n) emplace_back(value);
+        }
+        void clear() {
+            pages.clear();
+            count = 0;
+        }
+        void shrink_to_fit() {
+            pages.shrink_to_fit();
+        }
+
+        size_type size() const noexcept { return count; }
+        size_type capacity() const noexcept { return pages.size() << page_shift; }
+        bool empty() const noexcept { return count == 0; }
+        iterator begin() const noexcept { return iterator{ 0 }; }
+        iterator end() const noexcept { return iterator{ count }; }
+
+        // Pages this copy does not share with any other copy.
+        size_type exclusive_pages() const noexcept {
+            return static_cast<size_type>(std::count_if(pages.begin(), pages.end(), [](const auto& p) { return p.use_count() == 1; }));
+        }
+        size_type page_count() const noexcept {
+            return pages.size();
+        }
+
+    private:
+        struct page {
+            T values[page_elements];
+        };
+
+        page& writable(const size_type p) {
+            auto& ptr = pages[p];
+            if (ptr.use_count() != 1) ptr = std::make_shared<page>(*ptr);
+            return *ptr;
+        }
+
+        std::vector<std::shared_ptr<page>> pages;
+        size_type count = 0;
+    };
+
+    /**
+     * @brief Paged sparse index with pages shared copy-on-write between copies (see cow_vector).
+     *
+     * get()/find() are reads and never clone; every write goes through assure() or erase().
+     */
+    template <typename Entity, typename Allocator, size_t PageBits = pageBits>
+    class cow_sparse_index {
+    public:
+        static constexpr size_t page_size = size_t{ 1 } << PageBits;
+        static constexpr size_t page_mask = page_size - 1;
+
+        Entity* find(const size_t id) const {
+            const size_t bucketID = id >> PageBits;
+            if (pages.size() <= bucketID || !pages[bucketID]) return nullptr;
+            return &pages[bucketID]->slots[id & page_mask];
+        }
+        inline Entity& get(const size_t id) const {
+            return pages[id >> PageBits]->slots[id & page_mask];
+        }
+        inline void prefetch(const size_t id) const {
+            const size_t bucketID = id >> PageBits;
+            if (bucketID < pages.size() && pages[bucketID]) LEAPS_PREFETCH(&pages[bucketID]->slots[id & page_mask]);
+        }
+        Entity& assure(const size_t id) {
+            const size_t bucketID = id >> PageBits;
+            if (pages.size() <= bucketID) pages.resize(bucketID + 1);
+
+            auto& ptr = pages[bucketID];
+            if (!ptr) {
+                ptr = std::make_shared<page>();
+                std::fill(std::begin(ptr->slots), std::end(ptr->slots), Entity{ LEapsGL::null });
+            }
+            else if (ptr.use_count() != 1) ptr = std::make_shared<page>(*ptr);
+            return ptr->slots[id & page_mask];
+        }
+        void erase(const size_t id) {
+            assure(id) = LEapsGL::null;
+        }
+        void clear() {
+            pages.clear();
+        }
+        size_t memory_usage() const {
+            const auto used = std::count_if(pages.begin(), pages.end(), [](const auto& p) { return p != nullptr; });
+            return used * sizeof(page) + pages.capacity() * sizeof(std::shared_ptr<page>);
+        }
+        friend void swap(cow_sparse_index& lhs, cow_sparse_index& rhs) noexcept {
+            using std::swap;
+            swap(lhs.pages, rhs.pages);
+        }
+
+    private:
+        struct page {
+            Entity slots[page_size];
+        };
+        std::vector<std::shared_ptr<page>> pages;
+    };
+
+    namespace __internal {
+        template <typename T>
+        struct CPoolStorageSelector<AllocationType::CopyOnWrite, T> {
+            // Values that cannot be paged as bytes are deep-copied by World::fork().
+            using type = std::conditional_t<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                cow_vector<T>,
+                traits::to_component_storage_t<T>>;
+        };
+
+        template <size_t PageBits, typename Entity, typename Allocator>
+        struct CAllocationSparseIndexSelector<AllocationType::CopyOnWrite, SparseIndexType::Paged<PageBits>, Entity, Allocator> {
+            using type = cow_sparse_index<Entity, Allocator, PageBits>;
+        };
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <core/Type.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#if defined(MADV_HUGEPAGE)
+#define LEAPS_HUGE_PAGES_AVAILABLE
+#endif
+#endif
+
+namespace LEapsGL {
+
+    constexpr size_t huge_page_size = size_t{ 2 } << 20;
+
+    /*-----------------------------------------------------------------------*/
+    // Backing memory of a component's pool, selected per component:
+    //struct Transform {
+    //    using instance_type = glm::mat4;
+    //    using allocation_type = LEapsGL::AllocationType::HugePage;
+    //          // => Default, HugePage, CopyOnWrite (default: Default)
+    // };
+    // HugePage puts the sparse pages and the component array of Default/Dynamic/Tracked pools in 2 MB
+    // aligned regions advised with MADV_HUGEPAGE, cutting TLB misses of sweeps over millions of entities.
+    // Where transparent huge pages are unavailable (or disabled) the same regions use ordinary pages.
+    /*-----------------------------------------------------------------------*/
+    struct AllocationType {
+        struct AllocationTypeBase {};
+        struct Default : public AllocationTypeBase {};
+        struct HugePage : public AllocationTypeBase {};
+        // Pages shared with World::fork() copies until written (see CowStorage.h).
+        struct CopyOnWrite : public AllocationTypeBase {};
+    };
+
+    /**
+     * @brief Process-wide source of huge-page backed memory.
+     *
+     * Blocks of at least large_threshold bytes get their own 2 MB aligned mapping. Smaller blocks (sparse
+     * pages, hash nodes) are carved from shared 2 MB chunks and recycled through per-size free lists, so
+     * 64 default sparse pages share one huge page. Chunks are never returned to the OS.
+     */
+    class huge_page_arena {
+    public:
+        static constexpr size_t large_threshold = huge_page_size / 2;
+        static constexpr size_t granularity = 64;
+
+        static huge_page_arena& instance() {
+            static huge_page_arena arena;
+            return arena;
+        }
+
+        void* allocate(size_t bytes) {
+            if (bytes >= large_threshold) return map(bytes);
+            bytes = round_up(bytes == 0 ? 1 : bytes, granularity);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& list = freeLists[bytes];
+            if (!list.empty()) {
+                void* ptr = list.back();
+                list.pop_back();
+                return ptr;
+            }
+            if (remaining < bytes) {
+                cursor = static_cast<char*>(map(huge_page_size));
+                remaining = huge_page_size;
+            }
+            void* ptr = cursor;
+            cursor += bytes;
+            remaining -= bytes;
+            return ptr;
+        }
+        void deallocate(void* ptr, size_t bytes) noexcept {
+            if (!ptr) return;
+            if (bytes >= large_threshold) return unmap(ptr, bytes);
+            bytes = round_up(bytes == 0 ? 1 : bytes, granularity);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            freeLists[bytes].push_back(ptr);
+        }
+
+        // A huge_page_size aligned region of bytes (rounded up to whole huge pages).
+        static void* map(const size_t bytes) {
+#ifdef LEAPS_HUGE_PAGES_AVAILABLE
+            const size_t length = round_up(bytes, huge_page_size);
+            // Over-map by one huge page and trim, so the region starts on a 2 MB boundary.
+            void* raw = ::mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) throw std::bad_alloc();
+            char* base = static_cast<char*>(raw);
+            char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<size_t>(base), huge_page_size));
+            if (aligned != base) ::munmap(base, aligned - base);
+            if (const size_t tail = (base + length + huge_page_size) - (aligned + length)) ::munmap(aligned + length, tail);
+            ::madvise(aligned, length, MADV_HUGEPAGE); // EINVAL when THP is compiled out: ordinary pages
+            return aligned;
+#else
+            void* ptr = std::malloc(bytes);
+            if (!ptr) throw std::bad_alloc();
+            return ptr;
+#endif
+        }
+        static void unmap(void* ptr, const size_t bytes) noexcept {
+#ifdef LEAPS_HUGE_PAGES_AVAILABLE
+            ::munmap(ptr, round_up(bytes, huge_page_size));
+#else
+            std::free(ptr);
+#endif
+        }
+
+    private:
+        huge_page_arena() = default;
+
+        static constexpr size_t round_up(const size_t value, const size_t alignment) noexcept {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        std::mutex mutex;
+        char* cursor = nullptr;
+        size_t remaining = 0;
+        std::unordered_map<size_t, std::vector<void*>> freeLists;
+    };
+
+    // trivial_vector storage in huge pages; a block keeps its mapping while it grows within it.
+    struct huge_page_resource {
+        static void* reallocate(void* ptr, const size_t oldBytes, const size_t bytes) {
+            if (oldBytes < huge_page_arena::large_threshold && bytes < huge_page_arena::large_threshold) return std::realloc(ptr, bytes);
+            if (oldBytes >= huge_page_arena::large_threshold && bytes >= huge_page_arena::large_threshold
+                && mapped_length(oldBytes) == mapped_length(bytes)) return ptr;
+
+            void* grown;
+            try {
+                grown = bytes >= huge_page_arena::large_threshold ? huge_page_arena::map(bytes) : std::malloc(bytes);
+            }
+            catch (const std::bad_alloc&) {
+                return nullptr;
+            }
+            if (!grown) return nullptr;
+            if (ptr) std::memcpy(grown, ptr, oldBytes < bytes ? oldBytes : bytes);
+            deallocate(ptr, oldBytes);
+            return grown;
+        }
+        static void deallocate(void* ptr, const size_t bytes) noexcept {
+            if (!ptr) return;
+            if (bytes >= huge_page_arena::large_threshold) huge_page_arena::unmap(ptr, bytes);
+            else std::free(ptr);
+        }
+
+    private:
+        static constexpr size_t mapped_length(const size_t bytes) noexcept {
+            return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+        }
+    };
+
+    template <typename T>
+    struct huge_page_allocator {
+        using value_type = T;
+
+        huge_page_allocator() noexcept = default;
+        template <typename U>
+        huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+        T* allocate(const size_t n) {
+            static_assert(alignof(T) <= huge_page_arena::granularity, "huge_page_allocator cannot satisfy this alignment.");
+            return static_cast<T*>(huge_page_arena::instance().allocate(n * sizeof(T)));
+        }
+        void deallocate(T* ptr, const size_t n) noexcept {
+            huge_page_arena::instance().deallocate(ptr, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const huge_page_allocator<U>&) const noexcept {
+            return true;
+        }
+        template <typename U>
+        bool operator!=(const huge_page_allocator<U>&) const noexcept {
+            return false;
+        }
+    };
+
+    namespace __internal {
+        template <typename T, typename = void>
+        struct CAllocationMetaSelector {
+            using type = AllocationType::Default;
+        };
+
+        template <typename T>
+        struct CAllocationMetaSelector<T, std::void_t<typename T::allocation_type>> {
+            using type = typename T::allocation_type;
+        };
+
+        template <typename Tag, typename T>
+        struct CPoolStorageSelector {
+            using type = traits::to_component_storage_t<T>;
+        };
+
+        template <typename T>
+        struct CPoolStorageSelector<AllocationType::HugePage, T> {
+            using type = std::conditional_t<std::is_same_v<traits::to_component_storage_t<T>, trivial_vector<T>>,
+                trivial_vector<T, huge_page_resource>,
+                std::vector<T, huge_page_allocator<T>>>;
+        };
+
+        template <typename Tag, typename Allocator>
+        struct CHugeAllocatorSelector {
+            using type = Allocator;
+        };
+
+        template <typename Allocator>
+        struct CHugeAllocatorSelector<AllocationType::HugePage, Allocator> {
+            using type = huge_page_allocator<typename std::allocator_traits<Allocator>::value_type>;
+        };
+    }
+
+    namespace traits {
+        template <typename ComponentType>
+        using to_allocation_meta_t = typename __internal::CAllocationMetaSelector<ComponentType>::type;
+
+        // Component array of a pool for ComponentType holding Instance values.
+        template <typename ComponentType, typename Instance>
+        using to_pool_storage_t = typename __internal::CPoolStorageSelector<to_allocation_meta_t<ComponentType>, Instance>::type;
+
+        // Allocator for the sparse pages of ComponentType.
+        template <typename ComponentType, typename Allocator>
+        using to_sparse_allocator_t = typename __internal::CHugeAllocatorSelector<to_allocation_meta_t<ComponentType>, Allocator>::type;
+    }
+}
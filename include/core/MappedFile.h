@@ -0,0 +1,295 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <core/SparseIndex.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define LEAPS_MAPPED_FILE_AVAILABLE
+#endif
+
+namespace LEapsGL {
+
+#ifdef LEAPS_MAPPED_FILE_AVAILABLE
+    /**
+     * @brief Shared mapping of an anonymous (already unlinked) file.
+     *
+     * The backing file is created lazily in mapped_file::directory() (LEAPS_MAPPED_DIR, then TMPDIR, then /tmp),
+     * so the kernel can write pages back to it and drop them under memory pressure instead of swapping.
+     * Growing keeps the contents; the mapping itself may move, exactly like a reallocation.
+     */
+    class mapped_file {
+    public:
+        static constexpr size_t os_page = 4096;
+
+        mapped_file() = default;
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+        mapped_file(mapped_file&& rhs) noexcept {
+            swap(*this, rhs);
+        }
+        mapped_file& operator=(mapped_file&& rhs) noexcept {
+            mapped_file tmp(std::move(rhs));
+            swap(*this, tmp);
+            return *this;
+        }
+        ~mapped_file() {
+            if (base) ::munmap(base, length);
+            if (fd >= 0) ::close(fd);
+        }
+        friend void swap(mapped_file& lhs, mapped_file& rhs) noexcept {
+            using std::swap;
+            swap(lhs.fd, rhs.fd);
+            swap(lhs.base, rhs.base);
+            swap(lhs.length, rhs.length);
+        }
+
+        static std::string& directory() {
+            static std::string dir = [] {
+                if (const char* env = std::getenv("LEAPS_MAPPED_DIR")) return std::string(env);
+                if (const char* env = std::getenv("TMPDIR")) return std::string(env);
+                return std::string("/tmp");
+            }();
+            return dir;
+        }
+
+        void* data() const noexcept {
+            return base;
+        }
+        size_t size() const noexcept {
+            return length;
+        }
+
+        // Resize file and mapping to bytes (rounded up to whole OS pages). New bytes read as zero.
+        void resize(size_t bytes) {
+            bytes = (bytes + os_page - 1) / os_page * os_page;
+            if (bytes == length) return;
+            if (fd < 0) open();
+
+            // Grow the file before the mapping, shrink the mapping before the file.
+            if (bytes > length) {
+                if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) throw std::bad_alloc();
+                remap(bytes);
+            }
+            else {
+                remap(bytes);
+                if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) throw std::bad_alloc();
+            }
+        }
+        // madvise over [offset, offset + bytes), widened to OS pages.
+        void advise(const size_t offset, const size_t bytes, const int advice) const noexcept {
+            if (!base || offset >= length) return;
+            const size_t first = offset / os_page * os_page;
+            const size_t last = std::min(length, offset + bytes);
+            ::madvise(static_cast<char*>(base) + first, last - first, advice);
+        }
+
+    private:
+        void open() {
+            std::string path = directory() + "/leaps-pool-XXXXXX";
+            fd = ::mkstemp(path.data());
+            if (fd < 0) throw std::bad_alloc();
+            ::unlink(path.c_str());
+        }
+        void remap(const size_t bytes) {
+            if (bytes == 0) {
+                if (base) ::munmap(base, length);
+                base = nullptr;
+                length = 0;
+                return;
+            }
+            void* mapped;
+#ifdef __linux__
+            if (base) mapped = ::mremap(base, length, bytes, MREMAP_MAYMOVE);
+            else mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+#else
+            if (base) ::munmap(base, length);
+            mapped = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+#endif
+            if (mapped == MAP_FAILED) throw std::bad_alloc();
+            base = mapped;
+            length = bytes;
+        }
+
+        int fd = -1;
+        void* base = nullptr;
+        size_t length = 0;
+    };
+
+    /**
+     * @brief Growable array of trivially copyable values stored in a mapped_file.
+     *
+     * Mirrors the part of trivial_vector the component pools use, so it can replace the component
+     * array of a pool whose data does not fit in memory.
+     */
+    template <typename T>
+    class mapped_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "mapped_vector requires a trivially copyable type.");
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        mapped_vector() = default;
+        // Deep copy into a new backing file (World::fork()).
+        mapped_vector(const mapped_vector& rhs) {
+            reserve(rhs.count);
+            if (rhs.count) std::memcpy(data(), rhs.data(), rhs.count * sizeof(T));
+            count = rhs.count;
+        }
+        mapped_vector(mapped_vector&& rhs) noexcept : file{ std::move(rhs.file) }, count{ std::exchange(rhs.count, 0) }, cap{ std::exchange(rhs.cap, 0) } {}
+        mapped_vector& operator=(mapped_vector&& rhs) noexcept {
+            file = std::move(rhs.file);
+            count = std::exchange(rhs.count, 0);
+            cap = std::exchange(rhs.cap, 0);
+            return *this;
+        }
+
+        void reserve(const size_type n) {
+            if (n <= cap) return;
+            file.resize(n * sizeof(T));
+            cap = file.size() / sizeof(T);
+        }
+        void shrink_to_fit() {
+            file.resize(count * sizeof(T));
+            cap = file.size() / sizeof(T);
+        }
+        void resize(const size_type n, const T& value = T{}) {
+            if (n > count) insert(end(), n - count, value);
+            else count = n;
+        }
+        void clear() noexcept {
+            count = 0;
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            const T value(std::forward<Args>(args)...);
+            if (count == cap) reserve(next_capacity(count + 1));
+            std::memcpy(data() + count, &value, sizeof(T));
+            return data()[count++];
+        }
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+        void pop_back() noexcept {
+            --count;
+        }
+        iterator insert(const_iterator pos, const size_type n, const T& value) {
+            const size_type offset = pos - data();
+            if (n == 0) return data() + offset;
+            const T copy = value;
+            if (count + n > cap) reserve(next_capacity(count + n));
+            if (offset < count) std::memmove(data() + offset + n, data() + offset, (count - offset) * sizeof(T));
+            for (size_type i = 0; i < n; i++) std::memcpy(data() + offset + i, &copy, sizeof(T));
+            count += n;
+            return data() + offset;
+        }
+
+        // Read-ahead hints for a linear sweep.
+        void advise_sequential() const noexcept {
+            file.advise(0, count * sizeof(T), MADV_SEQUENTIAL);
+        }
+        void advise_willneed(const size_type first, const size_type n) const noexcept {
+            file.advise(first * sizeof(T), n * sizeof(T), MADV_WILLNEED);
+        }
+
+        T& operator[](const size_type i) noexcept { return data()[i]; }
+        const T& operator[](const size_type i) const noexcept { return data()[i]; }
+        T& back() noexcept { return data()[count - 1]; }
+        const T& back() const noexcept { return data()[count - 1]; }
+        T* data() noexcept { return static_cast<T*>(file.data()); }
+        const T* data() const noexcept { return static_cast<const T*>(file.data()); }
+
+        size_type size() const noexcept { return count; }
+        size_type capacity() const noexcept { return cap; }
+        bool empty() const noexcept { return count == 0; }
+
+        iterator begin() noexcept { return data(); }
+        const_iterator begin() const noexcept { return data(); }
+        iterator end() noexcept { return data() + count; }
+        const_iterator end() const noexcept { return data() + count; }
+
+    private:
+        size_type next_capacity(const size_type required) const noexcept {
+            size_type grown = cap ? cap * 2 : mapped_file::os_page / sizeof(T) + 1;
+            return grown < required ? required : grown;
+        }
+
+        mapped_file file;
+        size_type count = 0;
+        size_type cap = 0;
+    };
+
+    /**
+     * @brief Sparse index stored in a mapped_file that grows to cover the largest assured id.
+     *
+     * Like reserved_sparse_index, fresh slots read as zero and are validated against the packed array
+     * by sparse_array::contains, so erase() has nothing to do.
+     */
+    template <typename Entity, typename Allocator>
+    class mapped_sparse_index {
+        static_assert(std::is_trivially_copyable_v<Entity>, "Mapped sparse index requires a trivially copyable entity type.");
+
+    public:
+        mapped_sparse_index() = default;
+        mapped_sparse_index(const mapped_sparse_index& rhs) {
+            file.resize(rhs.file.size());
+            if (rhs.slots) std::memcpy(file.data(), rhs.file.data(), rhs.file.size());
+            slots = rhs.slots;
+        }
+        mapped_sparse_index(mapped_sparse_index&&) = default;
+        mapped_sparse_index& operator=(mapped_sparse_index&&) = default;
+
+        inline Entity* find(const size_t id) const {
+            if (id >= slots) return nullptr;
+            return static_cast<Entity*>(file.data()) + id;
+        }
+        inline Entity& get(const size_t id) const {
+            return static_cast<Entity*>(file.data())[id];
+        }
+        inline void prefetch(const size_t id) const {
+            if (id < slots) LEAPS_PREFETCH(static_cast<Entity*>(file.data()) + id);
+        }
+        Entity& assure(const size_t id) {
+            if (id >= slots) {
+                size_t grown = std::max<size_t>(slots, mapped_file::os_page / sizeof(Entity));
+                while (grown <= id) grown *= 2;
+                file.resize(grown * sizeof(Entity));
+                slots = file.size() / sizeof(Entity);
+            }
+            return get(id);
+        }
+        // Stale slots are validated against the packed array, so there is nothing to clear.
+        void erase(size_t) {
+        }
+        void clear() {
+            file.resize(0);
+            slots = 0;
+        }
+        size_t memory_usage() const {
+            return file.size();
+        }
+        friend void swap(mapped_sparse_index& lhs, mapped_sparse_index& rhs) noexcept {
+            using std::swap;
+            swap(lhs.file, rhs.file);
+            swap(lhs.slots, rhs.slots);
+        }
+
+    private:
+        mapped_file file;
+        size_t slots = 0;
+    };
+#endif
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+namespace LEapsGL {
+
+    /**
+     * @brief Small LZ77 byte codec used to compress cold component pages.
+     *
+     * The stream is a list of sequences: a token byte (literal count in the high nibble, match length - 4
+     * in the low nibble, 15 meaning "continued in following 255-terminated bytes"), the literals, then a
+     * 2-byte little-endian back-reference offset. The final sequence carries literals only. Matches are
+     * found through a single-probe hash of 4-byte prefixes, so compression is one linear pass and
+     * decompression is a plain copy loop.
+     */
+    struct page_codec {
+        static constexpr size_t min_match = 4;
+        static constexpr size_t max_offset = 0xFFFF;
+        static constexpr size_t hash_bits = 12;
+
+        static void compress(const std::uint8_t* src, const size_t size, std::vector<std::uint8_t>& out) {
+            out.clear();
+            out.reserve(size / 2 + 16);
+
+            std::uint32_t table[size_t{ 1 } << hash_bits] = {};
+            size_t anchor = 0;
+            size_t ip = 0;
+
+            while (ip + min_match <= size) {
+                const std::uint32_t h = hash(src + ip);
+                const size_t candidate = table[h];
+                table[h] = static_cast<std::uint32_t>(ip);
+
+                if (candidate >= ip || ip - candidate > max_offset || std::memcmp(src + candidate, src + ip, min_match) != 0) {
+                    ip++;
+                    continue;
+                }
+
+                size_t length = min_match;
+                while (ip + length < size && src[candidate + length] == src[ip + length]) length++;
+
+                write_sequence(out, src + anchor, ip - anchor, ip - candidate, length);
+                ip += length;
+                anchor = ip;
+            }
+            write_sequence(out, src + anchor, size - anchor, 0, 0);
+        }
+
+        // dst must hold exactly size bytes, the length the page was compressed from.
+        static void decompress(const std::uint8_t* src, const size_t srcSize, std::uint8_t* dst, const size_t size) {
+            const std::uint8_t* const end = src + srcSize;
+            size_t op = 0;
+
+            while (src < end) {
+                const std::uint8_t token = *src++;
+
+                size_t literals = token >> 4;
+                if (literals == 15) literals += read_length(src, end);
+                if (literals > size - op || literals > static_cast<size_t>(end - src)) throw std::length_error("page_codec: corrupt literal run");
+                std::memcpy(dst + op, src, literals);
+                src += literals;
+                op += literals;
+
+                if (src == end) break;
+
+                if (end - src < 2) throw std::length_error("page_codec: truncated offset");
+                const size_t offset = size_t{ src[0] } | (size_t{ src[1] } << 8);
+                src += 2;
+                size_t length = (token & 15);
+                if (length == 15) length += read_length(src, end);
+                length += min_match;
+                if (offset == 0 || offset > op || length > size - op) throw std::length_error("page_codec: corrupt match");
+
+                // An overlapping match repeats its last `offset` bytes: copy in chunks that double each step.
+                const size_t from = op - offset;
+                while (length > 0) {
+                    const size_t chunk = std::min(length, op - from);
+                    std::memcpy(dst + op, dst + from, chunk);
+                    op += chunk;
+                    length -= chunk;
+                }
+            }
+            if (op != size) throw std::length_error("page_codec: size mismatch");
+        }
+
+    private:
+        static inline std::uint32_t hash(const std::uint8_t* p) noexcept {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return (v * 2654435761u) >> (32 - hash_bits);
+        }
+        static void write_length(std::vector<std::uint8_t>& out, size_t length) {
+            while (length >= 255) {
+                out.push_back(255);
+                length -= 255;
+            }
+            out.push_back(static_cast<std::uint8_t>(length));
+        }
+        static size_t read_length(const std::uint8_t*& src, const std::uint8_t* end) {
+            size_t length = 0;
+            std::uint8_t b;
+            do {
+                if (src == end) throw std::length_error("page_codec: truncated length");
+                b = *src++;
+                length += b;
+            } while (b == 255);
+            return length;
+        }
+        // offset == 0 marks the trailing literal-only sequence.
+        static void write_sequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, const size_t literalCount, const size_t offset, const size_t length) {
+            const size_t matchCode = offset ? length - min_match : 0;
+            out.push_back(static_cast<std::uint8_t>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+            if (literalCount >= 15) write_length(out, literalCount - 15);
+            out.insert(out.end(), literals, literals + literalCount);
+            if (!offset) return;
+            out.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+            out.push_back(static_cast<std::uint8_t>(offset >> 8));
+            if (matchCode >= 15) write_length(out, matchCode - 15);
+        }
+    };
+}
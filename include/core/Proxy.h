@@ -44,33 +44,55 @@ namespace LEapsGL{
     // --------------------
     // 1) <entity_type, instance_type>::cache...
 
+    template <typename ComponentType>
+    struct ProxyRequestSpecification;
+
+    namespace __internal {
+        // Proxy bookkeeping of one component type. It lives in the current Context, so every Universe
+        // instance keeps its own; requestors must be created and destroyed under the same Universe::Scope.
+        template <typename ComponentType>
+        struct ProxyState : public IContext {
+            std::unordered_map<size_t, std::pair<std::unique_ptr<ProxyRequestSpecification<ComponentType>>, int>> counter;
+            std::unordered_map<size_t, traits::to_entity_t<ComponentType>> cachedEntity;
+            size_t totalVersion = 0;
+        };
+    }
+
     template <typename ComponentType>
     struct ProxyRequestSpecification{
         using instance_type = traits::to_instance_t<ComponentType>;
         using BaseSpec = ProxyRequestSpecification<ComponentType>;
         using baseSpecPtr = std::unique_ptr<BaseSpec>;
-        static inline std::unordered_map<size_t, std::pair<baseSpecPtr, int>> Counter;
 
-        static inline size_t totalVersion = 0;
+        virtual ~ProxyRequestSpecification() {};
+
+        static auto& Counter() {
+            return Context::getGlobalContext<__internal::ProxyState<ComponentType>>().counter;
+        }
+        static size_t& TotalVersion() {
+            return Context::getGlobalContext<__internal::ProxyState<ComponentType>>().totalVersion;
+        }
 
         inline static void increasement(const size_t x) {
-            BaseSpec::Counter[x].second++;
-            PROXY_SPECIFICATION_DEBUG_LOG("Hire: ID: " + std::to_string(x) + " Count: " + std::to_string(BaseSpec::Counter[x].second));
+            auto& count = BaseSpec::Counter()[x].second;
+            count++;
+            PROXY_SPECIFICATION_DEBUG_LOG("Hire: ID: " + std::to_string(x) + " Count: " + std::to_string(count));
         }
         inline static bool decrementEraseAndCheckIfZero(const size_t x) {
-            if (--BaseSpec::Counter[x].second == 0) {
-                BaseSpec::Counter.erase(x);
+            auto& counter = BaseSpec::Counter();
+            if (--counter[x].second == 0) {
+                counter.erase(x);
                 PROXY_SPECIFICATION_DEBUG_LOG("Fire: ID: " + std::to_string(x) + " Count: 0");
                 return true;
             }
             else {
-                PROXY_SPECIFICATION_DEBUG_LOG("Fire: ID: " + std::to_string(x) + " Count: " + std::to_string(BaseSpec::Counter[x].second));
+                PROXY_SPECIFICATION_DEBUG_LOG("Fire: ID: " + std::to_string(x) + " Count: " + std::to_string(counter[x].second));
                 return false;
             }
         }
 
         inline static instance_type GenerateInstance(size_t x) {
-            return BaseSpec::Counter[x].first->generateInstance();
+            return BaseSpec::Counter()[x].first->generateInstance();
         }
 
     private:
@@ -83,11 +105,11 @@ namespace LEapsGL{
     namespace __internal {
         class ProxyEntityBase {
         public:
-            using entity_type = std::uint32_t;
+            using entity_type = LEapsGL::CompactEntityType;
 
             constexpr ProxyEntityBase(const entity_type& d) : id(d) {};
             ProxyEntityBase(const ProxyEntityBase& d) : id(d.id) {};
-            uint32_t id;
+            entity_type id;
 
         };
     }
@@ -95,9 +117,9 @@ namespace LEapsGL{
     class ProxyEntity : public __internal::ProxyEntityBase {
     public:
         using super = __internal::ProxyEntityBase;
-        using entity_type = std::uint32_t;
+        using entity_type = LEapsGL::CompactEntityType;
 
-        constexpr ProxyEntity() : super(null_entity{}) {};
+        constexpr ProxyEntity() : super(static_cast<entity_type>(null_entity{})) {};
         constexpr ProxyEntity(const entity_type& d) : super(d) {};
         ProxyEntity(const ProxyEntity& entt) : super(entt.id) {};
         ProxyEntity(const ProxyEntityBase& entt) : super(entt.id) {};
@@ -119,13 +141,13 @@ namespace LEapsGL{
             using instance_type = typename traits::to_instance_t<component_type>;
             using BasePtrType = ProxyRequestSpecification<component_type>;
 
-            auto& Counter = BasePtrType::Counter;
+            auto& Counter = BasePtrType::Counter();
 
             size_t h = spec.hash();
             auto iter = Counter.find(h);
             if (iter == Counter.end()) {
                 iter = Counter.emplace(h, std::make_pair(std::make_unique<Specification>(spec), 0)).first;
-                ProxyRequestor<component_type>::cachedEntity[h] = null_entity{};
+                ProxyRequestor<component_type>::cachedEntity()[h] = null_entity{};
             }
 
             return ProxyRequestor<component_type>(h, 0);
@@ -152,10 +174,10 @@ namespace LEapsGL{
             swap(lhs.packedObject, rhs.packedObject);
             swap(lhs.version, rhs.version);
         }
-        const ProxyRequestor(const ProxyRequestor& rhs) : entt(rhs.entt), packedObject(rhs.packedObject), version(rhs.version) {
+        ProxyRequestor(const ProxyRequestor& rhs) : entt(rhs.entt), version(rhs.version), packedObject(rhs.packedObject) {
             BaseSpecType::increasement(packedObject);
         }
-        const ProxyRequestor(ProxyRequestor&& rhs) noexcept : ProxyRequestor() {
+        ProxyRequestor(ProxyRequestor&& rhs) noexcept : ProxyRequestor() {
             swap(*this, rhs);
         }
         
@@ -164,7 +186,7 @@ namespace LEapsGL{
             return *this;
         }
         virtual ~ProxyRequestor() {
-            if (BaseSpecType::decrementEraseAndCheckIfZero(packedObject)) ProxyRequestor::cachedEntity.erase(packedObject);
+            if (BaseSpecType::decrementEraseAndCheckIfZero(packedObject)) ProxyRequestor::cachedEntity().erase(packedObject);
         }
 
         // move constructor not need (swap and idiom)
@@ -192,10 +214,12 @@ namespace LEapsGL{
         friend Proxy;
         friend ProxyTraits;
 
-        // Cache
-        static inline std::unordered_map<size_t, proxy_entity_type> cachedEntity;
+        // Cache (per Context, see __internal::ProxyState)
+        static auto& cachedEntity() {
+            return Context::getGlobalContext<__internal::ProxyState<ComponentType>>().cachedEntity;
+        }
 
-        const ProxyRequestor(size_t packed, uint32_t ver) : entt(LEapsGL::null_entity{}), packedObject(packed), version(ver){
+        ProxyRequestor(size_t packed, uint32_t ver) : entt(LEapsGL::null_entity{}), version(ver), packedObject(packed) {
             BaseSpecType::increasement(packedObject);
         }
         void setVersion(size_t ver) {
@@ -207,7 +231,7 @@ namespace LEapsGL{
             return std::move(BaseSpecType::GenerateInstance(packedObject));
         }
 
-        ProxyRequestor() : entt(null_entity{}), packedObject(0), version(0) {
+        ProxyRequestor() : entt(null_entity{}), version(0), packedObject(0) {
             BaseSpecType::increasement(packedObject);
         };
 
@@ -226,20 +250,20 @@ namespace LEapsGL{
         /**
          * @brief Ensures the following for the given requestor:
          *        - The associated cached Entt (requestor.getHash()) exists: Requestor::cachedEntt[requestor.getHash]
-         *        - The Counter object exists: ProxyRequestSpecification::Counter[requestor.getHash]
+         *        - The Counter object exists: ProxyRequestSpecification::Counter()[requestor.getHash]
          */
         template<typename ComponentType>
         static void update_requestor(const ProxyRequestor<ComponentType>& requestor, bool shouldCreate = true) {
-            auto& M = ProxyRequestor<ComponentType>::cachedEntity;
+            auto& M = ProxyRequestor<ComponentType>::cachedEntity();
             auto& world = Universe::GetWorld<traits::to_world_t<ComponentType>>();
 
-            if (world.contains<ComponentType>(requestor.entt)) return;
+            if (world.template contains<ComponentType>(requestor.entt)) return;
 
             const size_t h = requestor.getHash();
             requestor.entt = M[h];
 
             // 3) from world
-            if (shouldCreate && !world.contains<ComponentType>(requestor.entt)) {
+            if (shouldCreate && !world.template contains<ComponentType>(requestor.entt)) {
                 // creation instance
                 requestor.entt = M[h] = world.Create();
             }
@@ -247,12 +271,22 @@ namespace LEapsGL{
     public:
         using SpecificationToEnttMap = std::unordered_map<size_t, __internal::ProxyEntityBase>;
 
+        /**
+         * @brief Follows World::defragment_ids() for the cached entities of ComponentType.
+         *
+         * Requestors still holding an old handle no longer find it in the world and reload it from the cache.
+         */
+        template<typename ComponentType>
+        static void remap(const entity_remap<typename traits::to_entity_t<ComponentType>>& table) {
+            for (auto& cached : ProxyRequestor<ComponentType>::cachedEntity()) cached.second = table(cached.second);
+        }
+
         template<typename ComponentType>
         static typename traits::to_instance_t<ComponentType>& assure(const ProxyRequestor<ComponentType>& requestor) {
             Proxy::update_requestor(requestor);
             auto& world = Universe::GetWorld<typename traits::to_world_t<ComponentType>>();
-            if (!world.contains<ComponentType>(requestor.entt)) world.emplace<ComponentType>(requestor.entt, requestor.generateInstance());
-            return world.query<ComponentType>(requestor.entt);
+            if (!world.template contains<ComponentType>(requestor.entt)) world.template emplace<ComponentType>(requestor.entt, requestor.generateInstance());
+            return world.template query<ComponentType>(requestor.entt);
         }
 
         template<typename ComponentType>
@@ -260,7 +294,7 @@ namespace LEapsGL{
             Proxy::update_requestor(requestor, false);
             auto& world = Universe::GetWorld<typename traits::to_world_t<ComponentType>>();
             traits::to_instance_t<ComponentType>* out = nullptr;
-            if (world.contains<ComponentType>(requestor.entt)) out = &world.query<ComponentType>(requestor.entt);
+            if (world.template contains<ComponentType>(requestor.entt)) out = &world.template query<ComponentType>(requestor.entt);
             return out;
         }
 
@@ -281,15 +315,15 @@ namespace LEapsGL{
          * 4) After removal, the ProxyRequestor's entt is set to `null_entity{}`.
          */
         template<typename ComponentType>
-        static typename bool remove(const ProxyRequestor<ComponentType>& requestor) {
+        static bool remove(const ProxyRequestor<ComponentType>& requestor) {
             bool res = false;
-            auto& M = ProxyRequestor<ComponentType>::cachedEntity;
+            auto& M = ProxyRequestor<ComponentType>::cachedEntity();
             auto& world = Universe::GetWorld<typename traits::to_world_t<ComponentType>>();
 
             // assure() returns an updated requestor
             Proxy::update_requestor(requestor);
 
-            res |= world.remove<ComponentType>(requestor.entt);
+            res |= world.template remove<ComponentType>(requestor.entt);
             requestor.entt = M[requestor.getHash()] = null_entity{};
             return res;
         }
@@ -318,7 +352,7 @@ namespace LEapsGL{
         template<typename ComponentType>
         static ProxyRequestor<ComponentType> prototype(const ProxyRequestor<ComponentType>& requestor) {
             auto newRequestor(requestor);
-            newRequestor.setVersion(++ProxyRequestSpecification<ComponentType>::totalVersion);
+            newRequestor.setVersion(++ProxyRequestSpecification<ComponentType>::TotalVersion());
 
             // Copy constructor & to rvalue
             Proxy::assure(newRequestor) = std::move(traits::to_instance_t<ComponentType>(Proxy::assure(requestor)));
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace LEapsGL {
+
+    /**
+     * @brief Fixed set of worker threads that run batches of independent tasks.
+     *
+     * run(count, fn) calls fn(0) ... fn(count - 1) on the workers and on the calling thread and returns
+     * once every call finished. Tasks are handed out through one shared counter, so an idle thread
+     * always takes the next unstarted task and a long task never holds back the rest of the batch.
+     * The first exception thrown by a task is rethrown by run() after the batch completes.
+     *
+     * Example usage:
+     * \code
+     * LEapsGL::TaskPool pool(3);               // 3 workers + the caller
+     * pool.run(systems.size(), [&](size_t i) { systems[i]->Update(); });
+     * \endcode
+     */
+    class TaskPool {
+    public:
+        explicit TaskPool(const size_t workers = default_workers()) {
+            resize(workers);
+        }
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+        ~TaskPool() {
+            stop();
+        }
+
+        // One worker per hardware thread besides the caller.
+        static size_t default_workers() noexcept {
+            const unsigned hardware = std::thread::hardware_concurrency();
+            return hardware > 1 ? hardware - 1 : 0;
+        }
+
+        void resize(const size_t workers) {
+            stop();
+            stopping = false;
+            for (size_t i = 0; i < workers; i++) threads.emplace_back([this] { work(); });
+        }
+        size_t size() const noexcept {
+            return threads.size();
+        }
+
+        void run(const size_t count, std::function<void(size_t)> fn) {
+            if (count == 0) return;
+            if (threads.empty() || count == 1) {
+                for (size_t i = 0; i < count; i++) fn(i);
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = std::move(fn);
+                total = count;
+                next.store(0, std::memory_order_relaxed);
+                busy = threads.size();
+                error = nullptr;
+                generation++;
+            }
+            wake.notify_all();
+            drain();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return busy == 0; });
+            job = nullptr;
+            if (error) std::rethrow_exception(std::exchange(error, nullptr));
+        }
+
+    private:
+        void work() {
+            std::uint64_t seen = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&] { return stopping || generation != seen; });
+                    if (stopping) return;
+                    seen = generation;
+                }
+                drain();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    busy--;
+                }
+                done.notify_one();
+            }
+        }
+        void drain() {
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < total; i = next.fetch_add(1, std::memory_order_relaxed)) {
+                try {
+                    job(i);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+            }
+        }
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& thread : threads) thread.join();
+            threads.clear();
+        }
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+
+        std::function<void(size_t)> job;
+        std::atomic<size_t> next{ 0 };
+        size_t total = 0;
+        size_t busy = 0;
+        std::uint64_t generation = 0;
+        bool stopping = false;
+        std::exception_ptr error;
+    };
+}
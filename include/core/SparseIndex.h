@@ -0,0 +1,349 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <new>
+#include <cstring>
+#include <stdexcept>
+
+#include <core/entity.h>
+#include <core/HugePage.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define LEAPS_SPARSE_RESERVED_AVAILABLE
+#endif
+
+// Read prefetch hint (no-op where unsupported).
+#if defined(__GNUC__) || defined(__clang__)
+#define LEAPS_PREFETCH(addr) __builtin_prefetch(static_cast<const void*>(addr))
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define LEAPS_PREFETCH(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#define LEAPS_PREFETCH(addr) ((void)(addr))
+#endif
+
+namespace LEapsGL {
+
+    // Default sparse page: 4096 entries
+    constexpr size_t pageBits = 12;
+    constexpr size_t pageMask = (1 << 12) - 1;
+    // Default id range of a reserved sparse index: 16M ids (128 MB of address space for 64-bit entities)
+    constexpr size_t reservedIdBits = 24;
+
+    /*-----------------------------------------------------------------------*/
+    // Sparse index (entity id -> packed index) strategy, selected per component:
+    //struct ComponentExample {
+    //    using sparse_index_type = LEapsGL::SparseIndexType::Hashed;
+    //          // => Flat, Paged<Bits>, Hashed, Reserved<IdBits> (default: Paged<pageBits>)
+    // };
+    /*-----------------------------------------------------------------------*/
+    struct SparseIndexType {
+        struct SparseIndexTypeBase {};
+        // One contiguous vector sized by the largest id. Best for small, dense id ranges.
+        struct Flat : public SparseIndexTypeBase {};
+        // Lazily allocated pages of (1 << PageBits) entries.
+        template <size_t PageBits = pageBits>
+        struct Paged : public SparseIndexTypeBase {};
+        // Hash map: memory proportional to the number of members. Best for very sparse components.
+        struct Hashed : public SparseIndexTypeBase {};
+        // Ids below (1 << IdBits) reserved in virtual memory, committed lazily by the OS. Lookup is a single indirection.
+        template <size_t IdBits = reservedIdBits>
+        struct Reserved : public SparseIndexTypeBase {};
+    };
+
+    /*
+        Every sparse index exposes the same interface to sparse_array:
+            Entity* find(id) const;    // nullptr if the slot was never assured
+            Entity& get(id) const;     // slot must exist
+            Entity& assure(id);        // creates the slot (filled with null) if needed
+            void erase(id);            // slot is no longer referenced
+            void prefetch(id) const;   // cache hint for an upcoming find(id)
+            void clear();
+            size_t memory_usage() const;
+    */
+    template <typename Entity, typename Allocator, size_t PageBits = pageBits>
+    class paged_sparse_index {
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using pointer = typename alloc_traits::pointer;
+        using page_list = std::vector<pointer, typename alloc_traits::template rebind_alloc<pointer>>;
+
+    public:
+        static constexpr size_t page_size = size_t{ 1 } << PageBits;
+        static constexpr size_t page_mask = page_size - 1;
+
+        paged_sparse_index() = default;
+        // Deep copy (World::fork()); only the allocated pages are duplicated.
+        paged_sparse_index(const paged_sparse_index& rhs) : pages(rhs.pages.size(), nullptr), allocator{ rhs.allocator } {
+            for (size_t i = 0; i < pages.size(); i++) {
+                if (!rhs.pages[i]) continue;
+                pages[i] = alloc_traits::allocate(allocator, page_size);
+                std::uninitialized_copy(rhs.pages[i], rhs.pages[i] + page_size, pages[i]);
+            }
+        }
+        paged_sparse_index& operator=(paged_sparse_index rhs) noexcept {
+            swap(*this, rhs);
+            return *this;
+        }
+        ~paged_sparse_index() {
+            clear();
+        }
+
+        Entity* find(const size_t id) const {
+            const size_t bucketID = id >> PageBits;
+            if (pages.size() <= bucketID || !pages[bucketID]) return nullptr;
+            return &pages[bucketID][id & page_mask];
+        }
+        inline Entity& get(const size_t id) const {
+            return pages[id >> PageBits][id & page_mask];
+        }
+        inline void prefetch(const size_t id) const {
+            const size_t bucketID = id >> PageBits;
+            if (bucketID < pages.size() && pages[bucketID]) LEAPS_PREFETCH(pages[bucketID] + (id & page_mask));
+        }
+        Entity& assure(const size_t id) {
+            const size_t bucketID = id >> PageBits;
+
+            if (pages.size() <= bucketID)
+                pages.resize(bucketID + 1, nullptr);
+
+            if (!pages[bucketID]) {
+                pages[bucketID] = alloc_traits::allocate(allocator, page_size);
+                std::uninitialized_fill(pages[bucketID], pages[bucketID] + page_size, LEapsGL::null);
+            }
+            return pages[bucketID][id & page_mask];
+        }
+        void erase(const size_t id) {
+            get(id) = LEapsGL::null;
+        }
+        void clear() {
+            for (auto&& page : pages) {
+                if (page != nullptr) {
+                    std::destroy(page, page + page_size);
+                    alloc_traits::deallocate(allocator, page, page_size);
+                    page = nullptr;
+                }
+            }
+            pages.clear();
+        }
+        size_t memory_usage() const {
+            const auto used = std::count_if(pages.begin(), pages.end(), [](const pointer page) { return page != nullptr; });
+            return used * page_size * sizeof(Entity) + pages.capacity() * sizeof(pointer);
+        }
+        friend void swap(paged_sparse_index& lhs, paged_sparse_index& rhs) noexcept {
+            using std::swap;
+            swap(lhs.pages, rhs.pages);
+            swap(lhs.allocator, rhs.allocator);
+        }
+
+    private:
+        page_list pages;
+        Allocator allocator;
+    };
+
+    template <typename Entity, typename Allocator>
+    class flat_sparse_index {
+    public:
+        Entity* find(const size_t id) const {
+            if (slots.size() <= id) return nullptr;
+            return const_cast<Entity*>(&slots[id]);
+        }
+        inline Entity& get(const size_t id) const {
+            return const_cast<Entity&>(slots[id]);
+        }
+        inline void prefetch(const size_t id) const {
+            if (id < slots.size()) LEAPS_PREFETCH(slots.data() + id);
+        }
+        Entity& assure(const size_t id) {
+            if (slots.size() <= id) {
+                size_t resized = std::max<size_t>(slots.size(), 1);
+                while (resized <= id) resized *= 2;
+                slots.resize(resized, LEapsGL::null);
+            }
+            return slots[id];
+        }
+        void erase(const size_t id) {
+            slots[id] = LEapsGL::null;
+        }
+        void clear() {
+            slots.clear();
+            slots.shrink_to_fit();
+        }
+        size_t memory_usage() const {
+            return slots.capacity() * sizeof(Entity);
+        }
+        friend void swap(flat_sparse_index& lhs, flat_sparse_index& rhs) noexcept {
+            using std::swap;
+            swap(lhs.slots, rhs.slots);
+        }
+
+    private:
+        std::vector<Entity, Allocator> slots;
+    };
+
+    template <typename Entity, typename Allocator>
+    class hashed_sparse_index {
+        using entity_type = typename entity_traits<Entity>::entity_type;
+        using map_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const entity_type, Entity>>;
+        using map_type = std::unordered_map<entity_type, Entity, std::hash<entity_type>, std::equal_to<entity_type>, map_allocator>;
+
+    public:
+        Entity* find(const size_t id) const {
+            auto iter = slots.find(static_cast<entity_type>(id));
+            if (iter == slots.end()) return nullptr;
+            return const_cast<Entity*>(&iter->second);
+        }
+        inline Entity& get(const size_t id) const {
+            return const_cast<Entity&>(slots.find(static_cast<entity_type>(id))->second);
+        }
+        // Node addresses are unknown until the bucket is read.
+        inline void prefetch(size_t) const {
+        }
+        Entity& assure(const size_t id) {
+            return slots.try_emplace(static_cast<entity_type>(id), LEapsGL::null).first->second;
+        }
+        void erase(const size_t id) {
+            slots.erase(static_cast<entity_type>(id));
+        }
+        void clear() {
+            slots.clear();
+        }
+        size_t memory_usage() const {
+            // node = (key, value, next) + bucket pointer
+            return slots.size() * (sizeof(typename map_type::value_type) + sizeof(void*)) + slots.bucket_count() * sizeof(void*);
+        }
+        friend void swap(hashed_sparse_index& lhs, hashed_sparse_index& rhs) noexcept {
+            using std::swap;
+            swap(lhs.slots, rhs.slots);
+        }
+
+    private:
+        map_type slots;
+    };
+
+#ifdef LEAPS_SPARSE_RESERVED_AVAILABLE
+    /**
+     * @brief Sparse index backed by one anonymous mapping that covers ids [0, 1 << IdBits).
+     *
+     * The mapping is created with MAP_NORESERVE, so only the OS pages that are written get committed.
+     * Where the kernel accounts for the whole mapping anyway (vm.overcommit_memory = 2) it still costs
+     * its full size, hence the bounded range rather than the whole entity id space; assuring an id past
+     * it throws std::length_error. Untouched slots read as zero; sparse_array::contains validates every
+     * slot against the packed array, so a zero slot is never mistaken for a member.
+     */
+    template <typename Entity, typename Allocator, size_t IdBits = reservedIdBits>
+    class reserved_sparse_index {
+        static_assert(std::is_trivially_copyable_v<Entity>, "Reserved sparse index requires a trivially copyable entity type.");
+        static constexpr size_t capacity = std::min(static_cast<size_t>(entity_traits<Entity>::entity_mask) + 1, size_t{ 1 } << IdBits);
+        static constexpr size_t reserved_bytes = capacity * sizeof(Entity);
+
+    public:
+        reserved_sparse_index() {
+            void* mapped = ::mmap(nullptr, reserved_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (mapped == MAP_FAILED) throw std::bad_alloc();
+            slots = static_cast<Entity*>(mapped);
+        }
+        // Deep copy: a fresh reservation with the assured prefix copied over.
+        reserved_sparse_index(const reserved_sparse_index& rhs) : reserved_sparse_index() {
+            std::memcpy(slots, rhs.slots, rhs.highWater * sizeof(Entity));
+            highWater = rhs.highWater;
+        }
+        reserved_sparse_index& operator=(const reserved_sparse_index&) = delete;
+        ~reserved_sparse_index() {
+            if (slots) ::munmap(slots, reserved_bytes);
+        }
+
+        inline Entity* find(const size_t id) const {
+            return id < capacity ? slots + id : nullptr;
+        }
+        inline Entity& get(const size_t id) const {
+            return slots[id];
+        }
+        inline void prefetch(const size_t id) const {
+            LEAPS_PREFETCH(slots + id);
+        }
+        inline Entity& assure(const size_t id) {
+            if (id >= capacity) throw std::length_error("reserved_sparse_index: entity id is outside the reserved range");
+            highWater = std::max(highWater, id + 1);
+            return slots[id];
+        }
+        // Stale slots are validated against the packed array, so there is nothing to clear.
+        void erase(size_t) {
+        }
+        void clear() {
+            // Drop committed pages; the range stays reserved and reads as zero again.
+            ::madvise(slots, reserved_bytes, MADV_DONTNEED);
+            highWater = 0;
+        }
+        size_t memory_usage() const {
+            // Upper bound: every OS page up to the highest assured slot.
+            constexpr size_t os_page = 4096;
+            return (highWater * sizeof(Entity) + os_page - 1) / os_page * os_page;
+        }
+        friend void swap(reserved_sparse_index& lhs, reserved_sparse_index& rhs) noexcept {
+            using std::swap;
+            swap(lhs.slots, rhs.slots);
+            swap(lhs.highWater, rhs.highWater);
+        }
+
+    private:
+        Entity* slots = nullptr;
+        size_t highWater = 0;
+    };
+#endif
+
+    namespace __internal {
+        template <typename Tag, typename Entity, typename Allocator>
+        struct SparseIndexSelector;
+
+        template <typename Entity, typename Allocator>
+        struct SparseIndexSelector<SparseIndexType::Flat, Entity, Allocator> {
+            using type = flat_sparse_index<Entity, Allocator>;
+        };
+        template <size_t PageBits, typename Entity, typename Allocator>
+        struct SparseIndexSelector<SparseIndexType::Paged<PageBits>, Entity, Allocator> {
+            using type = paged_sparse_index<Entity, Allocator, PageBits>;
+        };
+        template <typename Entity, typename Allocator>
+        struct SparseIndexSelector<SparseIndexType::Hashed, Entity, Allocator> {
+            using type = hashed_sparse_index<Entity, Allocator>;
+        };
+        template <size_t IdBits, typename Entity, typename Allocator>
+        struct SparseIndexSelector<SparseIndexType::Reserved<IdBits>, Entity, Allocator> {
+#ifdef LEAPS_SPARSE_RESERVED_AVAILABLE
+            using type = reserved_sparse_index<Entity, Allocator, IdBits>;
+#else
+            // No lazily committed reservation on this platform: fall back to the default pages.
+            using type = paged_sparse_index<Entity, Allocator>;
+#endif
+        };
+
+        template <typename T, typename = void>
+        struct CSparseIndexMetaSelector {
+            using type = SparseIndexType::Paged<>;
+        };
+
+        template <typename T>
+        struct CSparseIndexMetaSelector<T, std::void_t<typename T::sparse_index_type>> {
+            using type = typename T::sparse_index_type;
+        };
+
+        // An allocation type may replace the index it backs (see CowStorage.h).
+        template <typename AllocationTag, typename Tag, typename Entity, typename Allocator>
+        struct CAllocationSparseIndexSelector {
+            using type = typename SparseIndexSelector<Tag, Entity, Allocator>::type;
+        };
+    }
+
+    namespace traits {
+        template <typename ComponentType>
+        using to_sparse_index_meta_t = typename __internal::CSparseIndexMetaSelector<ComponentType>::type;
+
+        template <typename ComponentType, typename Entity, typename Allocator>
+        using to_sparse_index_t = typename __internal::CAllocationSparseIndexSelector<to_allocation_meta_t<ComponentType>,
+            to_sparse_index_meta_t<ComponentType>, Entity, to_sparse_allocator_t<ComponentType, Allocator>>::type;
+    }
+}
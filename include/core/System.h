@@ -4,16 +4,59 @@
 #include "Container.h"
 #include "Type.h"
 #include <unordered_map>
+#include <vector>
+#include <algorithm>
 
 namespace LEapsGL {
+    struct SystemAccess;
+
+    namespace __internal {
+        // How a system's declared access to Type is scheduled and prepared (defined in World.h).
+        template <typename Type>
+        struct component_access;
+    }
+
     class BaseSystem {
     public:
         virtual void Configure() = 0; /* Register event system */
         virtual void Unconfigure() = 0; /* Register event system */
         virtual void Start() = 0; 
         virtual void Update() = 0;
+
+        // Components the system touches; nullptr (the default) means it may touch anything and runs alone.
+        virtual const SystemAccess* Access() const {
+            return nullptr;
+        }
+    };
+
+    /*
+        Declared component access of a system. Two systems conflict when one writes a component the other
+        reads or writes; Universe::Update runs non-conflicting systems concurrently (see ParallelSystem).
+        Reads of last frame's committed values (previous) conflict with nothing: only swap_buffers() writes
+        them, after every system has run. prepare creates the declared pools before a concurrent batch starts.
+    */
+    struct SystemAccess {
+        std::vector<size_t> reads;
+        std::vector<size_t> writes;
+        std::vector<size_t> previous;
+        std::vector<void (*)()> prepare;
+
+        bool conflicts(const SystemAccess& rhs) const {
+            auto overlaps = [](const std::vector<size_t>& lhs, const std::vector<size_t>& rhs) {
+                return std::any_of(lhs.begin(), lhs.end(), [&](size_t id) { return std::find(rhs.begin(), rhs.end(), id) != rhs.end(); });
+            };
+            return overlaps(writes, rhs.writes) || overlaps(writes, rhs.reads) || overlaps(reads, rhs.writes);
+        }
     };
 
+    template <typename... Types>
+    struct Read {};
+    template <typename... Types>
+    struct Write {};
+    // DoubleBuffered components read through previous() only.
+    template <typename... Types>
+    struct ReadPrevious {};
+
     class DefaultSystem : public BaseSystem{
     public:
         virtual void Configure() {
@@ -26,6 +69,47 @@ namespace LEapsGL {
         }
     };
 
+    template <typename Reads, typename Writes = Write<>, typename Previous = ReadPrevious<>>
+    class ParallelSystem;
+
+    /**
+     * @brief System that declares the components it reads and writes, so it may run alongside others.
+     *
+     * Update() may run on a worker thread concurrently with any system it does not conflict with. It may
+     * read and write the values of its declared components only: creating or destroying entities, emplacing
+     * or removing components and scheduling timers are not thread-safe and belong in an AFTER_SYSTEM event
+     * handler or an undeclared (exclusive) system. Events it emits with AFTER_SYSTEM / AFTER_UPDATE are
+     * delivered in registration order once its batch has finished; DIRECT subscribers run on its thread.
+     *
+     * Read<T> of a CopyOnWrite or Cold component is scheduled as a write: reading those pools through a
+     * mutable path detaches shared pages or fills the page cache. ReadPrevious<T> (DoubleBuffered T) reads
+     * previous() and may run alongside a Write<T> system.
+     *
+     * Example usage:
+     * \code
+     * class Movement : public LEapsGL::ParallelSystem<LEapsGL::Read<Velocity>, LEapsGL::Write<Position>> {
+     *     void Update() override { ... }
+     * };
+     * \endcode
+     */
+    template <typename... ReadTypes, typename... WriteTypes, typename... PreviousTypes>
+    class ParallelSystem<Read<ReadTypes...>, Write<WriteTypes...>, ReadPrevious<PreviousTypes...>> : public DefaultSystem {
+    public:
+        const SystemAccess* Access() const override {
+            static_assert((__internal::component_access<PreviousTypes>::double_buffered && ...), "ReadPrevious<T> requires ContainerType::DoubleBuffered.");
+            static const SystemAccess access = [] {
+                SystemAccess declared;
+                ((__internal::component_access<ReadTypes>::shared_reads ? declared.reads : declared.writes).push_back(get_type_hash<ReadTypes>()), ...);
+                (declared.writes.push_back(get_type_hash<WriteTypes>()), ...);
+                (declared.previous.push_back(get_type_hash<PreviousTypes>()), ...);
+                declared.prepare = { &__internal::component_access<ReadTypes>::prepare..., &__internal::component_access<WriteTypes>::prepare...,
+                    &__internal::component_access<PreviousTypes>::prepare... };
+                return declared;
+            }();
+            return &access;
+        }
+    };
+
     namespace __internal {
         class BaseEventSubscriber {
         public:
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+namespace LEapsGL {
+
+    /**
+     * @brief Hierarchical timer wheel over an abstract tick counter (frames, milliseconds, ...).
+     *
+     * Level L has 64 slots of 64^L ticks each. A timer is filed at the lowest level whose slot still
+     * separates it from the current tick; when the clock enters a higher-level slot its timers are
+     * re-filed one level down. Scheduling and cancelling are O(1), and a tick touches only the timers
+     * that expire on it plus the ones being cascaded. Timers further out than the top level wait in
+     * an overflow list that is re-filed once per top-level revolution.
+     *
+     * Example usage:
+     * \code
+     * LEapsGL::TimerWheel wheel;
+     * auto handle = wheel.schedule(90, [] { ... });  // fires during the 90th advance() tick from now
+     * wheel.cancel(handle);
+     * wheel.advance(1);
+     * \endcode
+     */
+    class TimerWheel {
+    public:
+        using tick_type = std::uint64_t;
+        using callback_type = std::function<void()>;
+
+        struct handle {
+            std::uint32_t index = invalid_index;
+            std::uint32_t generation = 0;
+        };
+
+        static constexpr size_t slot_bits = 6;
+        static constexpr size_t slot_count = size_t{ 1 } << slot_bits;
+        static constexpr size_t level_count = 4;
+
+        // Fire fn after delay ticks (a delay of 0 fires on the next tick).
+        handle schedule(const tick_type delay, callback_type fn) {
+            const std::uint32_t index = allocate();
+            timer_node& node = nodes[index];
+            node.when = now + (delay == 0 ? 1 : delay);
+            node.fn = std::move(fn);
+            node.active = true;
+            file(index);
+            pending++;
+            return handle{ index, node.generation };
+        }
+
+        // Returns false if the timer already fired or was cancelled.
+        bool cancel(const handle h) {
+            if (h.index >= nodes.size()) return false;
+            timer_node& node = nodes[h.index];
+            if (node.generation != h.generation || !node.active) return false;
+            node.active = false;
+            node.fn = nullptr;
+            pending--;
+            return true;
+        }
+
+        // Advance the clock tick by tick, running every timer that expires on the way.
+        void advance(const tick_type ticks) {
+            for (tick_type i = 0; i < ticks; i++) {
+                now++;
+                cascade();
+
+                const std::uint32_t head = detach(levels[0][now & slot_mask]);
+                for (std::uint32_t index = head; index != invalid_index;) {
+                    const std::uint32_t next = nodes[index].next;
+                    if (nodes[index].active) {
+                        callback_type fn = std::move(nodes[index].fn);
+                        release(index);
+                        pending--;
+                        fn(); // may schedule or cancel other timers
+                    }
+                    else release(index);
+                    index = next;
+                }
+            }
+        }
+
+        tick_type current() const noexcept {
+            return now;
+        }
+        // Timers scheduled and neither fired nor cancelled.
+        size_t size() const noexcept {
+            return pending;
+        }
+
+    private:
+        static constexpr std::uint32_t invalid_index = ~std::uint32_t{ 0 };
+        static constexpr tick_type slot_mask = slot_count - 1;
+
+        struct timer_node {
+            tick_type when = 0;
+            callback_type fn;
+            std::uint32_t next = invalid_index;
+            std::uint32_t generation = 0;
+            bool active = false;
+        };
+
+        std::uint32_t allocate() {
+            if (!freeNodes.empty()) {
+                const std::uint32_t index = freeNodes.back();
+                freeNodes.pop_back();
+                return index;
+            }
+            nodes.emplace_back();
+            return static_cast<std::uint32_t>(nodes.size() - 1);
+        }
+        void release(const std::uint32_t index) {
+            nodes[index].fn = nullptr;
+            nodes[index].active = false;
+            nodes[index].generation++;
+            freeNodes.push_back(index);
+        }
+
+        static std::uint32_t detach(std::uint32_t& slot) noexcept {
+            const std::uint32_t head = slot;
+            slot = invalid_index;
+            return head;
+        }
+        static void push(std::uint32_t& slot, std::vector<timer_node>& nodes, const std::uint32_t index) noexcept {
+            nodes[index].next = slot;
+            slot = index;
+        }
+
+        // Lowest level at which `when` and `now` share every higher digit.
+        void file(const std::uint32_t index) {
+            const tick_type when = nodes[index].when;
+            for (size_t level = 0; level < level_count; level++) {
+                if (((when ^ now) >> (slot_bits * (level + 1))) == 0) {
+                    push(levels[level][(when >> (slot_bits * level)) & slot_mask], nodes, index);
+                    return;
+                }
+            }
+            push(overflow, nodes, index);
+        }
+
+        // Re-file the slots the clock just entered, highest level first.
+        void cascade() {
+            if ((now & ((tick_type{ 1 } << (slot_bits * level_count)) - 1)) == 0) refile(detach(overflow));
+            for (size_t level = level_count - 1; level > 0; level--) {
+                if ((now & ((tick_type{ 1 } << (slot_bits * level)) - 1)) != 0) continue;
+                refile(detach(levels[level][(now >> (slot_bits * level)) & slot_mask]));
+            }
+        }
+        void refile(std::uint32_t index) {
+            while (index != invalid_index) {
+                const std::uint32_t next = nodes[index].next;
+                if (nodes[index].active) file(index);
+                else release(index);
+                index = next;
+            }
+        }
+
+        tick_type now = 0;
+        size_t pending = 0;
+        std::vector<timer_node> nodes;
+        std::vector<std::uint32_t> freeNodes;
+        std::array<std::array<std::uint32_t, slot_count>, level_count> levels = make_levels();
+        std::uint32_t overflow = invalid_index;
+
+        static std::array<std::array<std::uint32_t, slot_count>, level_count> make_levels() noexcept {
+            std::array<std::array<std::uint32_t, slot_count>, level_count> out;
+            for (auto& level : out) level.fill(invalid_index);
+            return out;
+        }
+    };
+}
@@ -1,5 +1,10 @@
 #pragma once
 #include <cstring>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
 #include <core/CoreSetting.h>
 #include <stdexcept>
 
@@ -44,6 +49,165 @@ namespace LEapsGL {
         std::vector<T> data;
     };
 
+    // Default trivial_vector storage: the C heap, so growth can extend blocks in place.
+    struct heap_resource {
+        static void* reallocate(void* ptr, const std::size_t, const std::size_t bytes) {
+            return std::realloc(ptr, bytes);
+        }
+        static void deallocate(void* ptr, const std::size_t) noexcept {
+            std::free(ptr);
+        }
+    };
+
+    /**
+     * @brief Growable array for trivially copyable types.
+     *
+     * Elements are relocated with memcpy/memmove and storage grows through Resource::reallocate
+     * (std::realloc by default), which can extend large blocks in place instead of copying them.
+     */
+    template <typename T, typename Resource = heap_resource>
+    class trivial_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "trivial_vector requires a trivially copyable type.");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "trivial_vector cannot satisfy over-aligned types.");
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        trivial_vector() = default;
+        trivial_vector(const trivial_vector& rhs) {
+            reserve(rhs.count);
+            if (rhs.count) std::memcpy(storage, rhs.storage, rhs.count * sizeof(T));
+            count = rhs.count;
+        }
+        trivial_vector(trivial_vector&& rhs) noexcept {
+            swap(*this, rhs);
+        }
+        trivial_vector& operator=(trivial_vector rhs) noexcept {
+            swap(*this, rhs);
+            return *this;
+        }
+        ~trivial_vector() {
+            Resource::deallocate(storage, cap * sizeof(T));
+        }
+        friend void swap(trivial_vector& lhs, trivial_vector& rhs) noexcept {
+            using std::swap;
+            swap(lhs.storage, rhs.storage);
+            swap(lhs.count, rhs.count);
+            swap(lhs.cap, rhs.cap);
+        }
+
+        void reserve(const size_type n) {
+            if (n <= cap) return;
+            void* grown = Resource::reallocate(storage, cap * sizeof(T), n * sizeof(T));
+            if (!grown) throw std::bad_alloc();
+            storage = static_cast<T*>(grown);
+            cap = n;
+        }
+        void shrink_to_fit() {
+            if (count == 0) {
+                Resource::deallocate(storage, cap * sizeof(T));
+                storage = nullptr;
+                cap = 0;
+            }
+            else if (count < cap) {
+                if (void* shrunk = Resource::reallocate(storage, cap * sizeof(T), count * sizeof(T))) {
+                    storage = static_cast<T*>(shrunk);
+                    cap = count;
+                }
+            }
+        }
+        void resize(const size_type n) {
+            resize(n, T{});
+        }
+        void resize(const size_type n, const T& value) {
+            if (n > count) insert(end(), n - count, value);
+            else count = n;
+        }
+        void clear() noexcept {
+            count = 0;
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            const T value(std::forward<Args>(args)...); // args may refer into this vector
+            if (count == cap) reserve(next_capacity(count + 1));
+            std::memcpy(storage + count, &value, sizeof(T));
+            return storage[count++];
+        }
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+        void pop_back() noexcept {
+            --count;
+        }
+        iterator insert(const_iterator pos, const size_type n, const T& value) {
+            const size_type offset = pos - storage;
+            if (n == 0) return storage + offset;
+            const T copy = value; // value may live inside this vector
+            if (count + n > cap) reserve(next_capacity(count + n));
+            if (offset < count) std::memmove(storage + offset + n, storage + offset, (count - offset) * sizeof(T));
+            for (size_type i = 0; i < n; i++) std::memcpy(storage + offset + i, &copy, sizeof(T));
+            count += n;
+            return storage + offset;
+        }
+        iterator insert(const_iterator pos, const T* first, const T* last) {
+            const size_type offset = pos - storage;
+            const size_type n = last - first;
+            if (n == 0) return storage + offset;
+            if (count + n > cap) reserve(next_capacity(count + n));
+            if (offset < count) std::memmove(storage + offset + n, storage + offset, (count - offset) * sizeof(T));
+            std::memcpy(storage + offset, first, n * sizeof(T));
+            count += n;
+            return storage + offset;
+        }
+
+        T& operator[](const size_type i) noexcept { return storage[i]; }
+        const T& operator[](const size_type i) const noexcept { return storage[i]; }
+        T& back() noexcept { return storage[count - 1]; }
+        const T& back() const noexcept { return storage[count - 1]; }
+        T* data() noexcept { return storage; }
+        const T* data() const noexcept { return storage; }
+
+        size_type size() const noexcept { return count; }
+        size_type capacity() const noexcept { return cap; }
+        bool empty() const noexcept { return count == 0; }
+
+        iterator begin() noexcept { return storage; }
+        const_iterator begin() const noexcept { return storage; }
+        iterator end() noexcept { return storage + count; }
+        const_iterator end() const noexcept { return storage + count; }
+
+    private:
+        size_type next_capacity(const size_type required) const noexcept {
+            size_type grown = cap ? cap * 2 : 8;
+            return grown < required ? required : grown;
+        }
+
+        T* storage = nullptr;
+        size_type count = 0;
+        size_type cap = 0;
+    };
+
+    namespace __internal {
+        template <typename T, typename = void>
+        struct CRelocatableStorageSelector {
+            using type = std::vector<T>;
+        };
+
+        template <typename T>
+        struct CRelocatableStorageSelector<T, std::enable_if_t<std::is_trivially_copyable_v<T> && (alignof(T) <= alignof(std::max_align_t))>> {
+            using type = trivial_vector<T>;
+        };
+    }
+
+    namespace traits {
+        // Component array type: trivial_vector for trivially copyable instances, std::vector otherwise.
+        template <typename T>
+        using to_component_storage_t = typename __internal::CRelocatableStorageSelector<T>::type;
+    }
+
     template <typename Type, typename Writer>
     struct ReadOnlyType {
         const Type& getValue() const {
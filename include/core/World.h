@@ -1,7 +1,11 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <queue>
+#include <stdexcept>
+#include <chrono>
+#include <optional>
 
 #include <core/Core.h>
 #include <core/entity.h>
@@ -9,6 +13,14 @@
 #include <core/Type.h>
 #include <core/System.h>
 #include <core/CoreSetting.h>
+#include <core/TimerWheel.h>
+#include <core/Scheduler.h>
+#include <core/Coroutine.h>
+
+#ifdef LEAPS_COROUTINES_AVAILABLE
+#include <deque>
+#include <future>
+#endif
 
 namespace LEapsGL {
     /*-----------------------------------------------------------------------*/
@@ -16,8 +28,14 @@ namespace LEapsGL {
     //struct ComponentExample {
     //    using entity_type = uint64_t; // Dependency<T>, ProxyEntity<T>
     //    using container_type = ...; /*Defualt: Dynamic Component Pool ...*/ 
-    //          // => ContainerType::Dynamic, ContainerType::Flag, ContainerType::MemoryOptimized, 
+    //          // => ContainerType::Dynamic, ContainerType::Flag, ContainerType::MemoryOptimized, ContainerType::Unique, ContainerType::Shared, ContainerType::Tracked, ContainerType::Arena, ContainerType::Cold, ContainerType::Mapped, ContainerType::DoubleBuffered
     //    using instance_type = ...; // real instance type
+    //    using sparse_index_type = ...; /*Default: SparseIndexType::Paged<>*/
+    //          // => SparseIndexType::Flat, SparseIndexType::Paged<Bits>, SparseIndexType::Hashed, SparseIndexType::Reserved<IdBits>
+    //    using index_type = ...; /*Default: none*/
+    //          // => IndexType::Hashed<KeyFn>, IndexType::Ordered<KeyFn> (see ComponentIndex.h)
+    //    using allocation_type = ...; /*Default: AllocationType::Default*/
+    //          // => AllocationType::HugePage (see HugePage.h), AllocationType::CopyOnWrite (see CowStorage.h, World::fork())
     // };
     /*-----------------------------------------------------------------------*/
     struct ContainerType {
@@ -26,6 +44,13 @@ namespace LEapsGL {
         struct Flag : public ContainerTypeBase {};
         struct Default  : public ContainerTypeBase {};
         struct Dynamic  : public ContainerTypeBase {};
+        struct Unique  : public ContainerTypeBase {};
+        struct Shared  : public ContainerTypeBase {};
+        struct Tracked  : public ContainerTypeBase {};
+        struct Arena  : public ContainerTypeBase {}; // instance_type = std::vector<Element>
+        struct Cold  : public ContainerTypeBase {}; // compressed pages, trivially copyable instance_type
+        struct Mapped  : public ContainerTypeBase {}; // memory-mapped files, trivially copyable instance_type
+        struct DoubleBuffered  : public ContainerTypeBase {}; // previous() = last frame, committed by Universe::Update
     };
     namespace __internal {
         template <typename T, typename = void>
@@ -83,6 +108,58 @@ namespace LEapsGL {
         struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Flag>>> {
             using type = FlagComponentPool<T, CEntity_t<T>>;
         };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Unique>>> {
+            using type = UniqueComponentPool<T, CEntity_t<T>>;
+        };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Shared>>> {
+            using type = SharedComponentPool<T, CEntity_t<T>>;
+        };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Tracked>>> {
+            using type = TrackedComponentPool<T, CEntity_t<T>>;
+        };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Arena>>> {
+            using type = ArenaComponentPool<T, CEntity_t<T>>;
+        };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Cold>>> {
+            using type = ColdComponentPool<T, CEntity_t<T>>;
+        };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::Mapped>>> {
+#ifdef LEAPS_MAPPED_FILE_AVAILABLE
+            using type = MappedComponentPool<T, CEntity_t<T>>;
+#else
+            // No file mappings on this platform: fall back to the default pool.
+            using type = DefaultComponentPool<T, CEntity_t<T>>;
+#endif
+        };
+        template <typename T>
+        struct CContainerSelector<T, std::enable_if_t<std::is_same_v<typename T::container_type, ContainerType::DoubleBuffered>>> {
+            using type = DoubleBufferedComponentPool<T, CEntity_t<T>>;
+        };
+
+        // Components that declare index_type get their value pool wrapped with a secondary index.
+        template <typename T, typename = void>
+        struct CIndexedContainerSelector {
+            using type = typename CContainerSelector<T>::type;
+        };
+
+        template <typename T>
+        struct CIndexedContainerSelector<T, std::void_t<typename T::index_type>> {
+            static_assert(!std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::Flag>
+                && !std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::Unique>
+                && !std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::Shared>
+                && !std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::Tracked>
+                && !std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::Arena>
+                && !std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::Cold>
+                && !std::is_same_v<typename CContainerMetaSelector<T>::type, ContainerType::DoubleBuffered>,
+                "index_type is supported only on Default, Dynamic and MemoryOptimized containers.");
+            using type = IndexedComponentPool<T, CEntity_t<T>, typename CContainerSelector<T>::type>;
+        };
     }
 
     //template <typename ComponentType>
@@ -93,7 +170,7 @@ namespace LEapsGL {
 
     namespace traits {
         template <typename ComponentType>
-        using to_container_t = typename __internal::CContainerSelector<ComponentType>::type;
+        using to_container_t = typename __internal::CIndexedContainerSelector<ComponentType>::type;
         //(e.g.,) LEapsGL::ComponentTraits::to_container_t<ComponentType>;
 
         template <typename ComponentType>
@@ -129,13 +206,144 @@ namespace LEapsGL {
         DIRECT, AFTER_SYSTEM, AFTER_UPDATE
     };
 
+    // Unit of a Universe timer delay.
+    enum class TimerClock {
+        FRAME, MILLISECOND
+    };
+
+    // Phases of Universe::Frame, in execution order; FIXED_UPDATE runs zero or more times per frame.
+    enum class FramePhase {
+        INPUT, FIXED_UPDATE, UPDATE, LATE_UPDATE, RENDER
+    };
+    constexpr size_t frame_phase_count = 5;
+    // LOW systems are skipped while a frame or its current phase is over budget (see FrameSettings).
+    enum class SystemPriority {
+        HIGH, NORMAL, LOW
+    };
+
+    struct FrameSettings {
+        double fixedHz = 60.0;
+        // Catch-up limit: fixed steps per frame. Backlog beyond it is dropped instead of spiralling.
+        unsigned maxFixedSteps = 5;
+        // Time after which LOW systems are skipped for the rest of the frame (zero: no budget).
+        std::chrono::nanoseconds budget{ 0 };
+        // Same per phase, indexed by FramePhase and measured from the start of the phase (of each fixed step
+        // for FIXED_UPDATE). A LOW system is skipped once either its phase or the frame is over budget.
+        std::array<std::chrono::nanoseconds, frame_phase_count> phaseBudgets{};
+        // A LOW system skipped this many frames in a row runs regardless of the budget.
+        unsigned maxDeferredFrames = 4;
+        // Coroutine resumptions per frame; the rest wait for the next frame (zero: no limit).
+        size_t maxCoroutineResumes = 0;
+    };
+
+    struct FrameTime {
+        std::uint64_t frame = 0;
+        std::chrono::nanoseconds delta{ 0 };
+        std::chrono::nanoseconds fixedDelta{ 0 };
+        unsigned fixedSteps = 0;
+        // Fraction of a fixed step left in the accumulator: blend previous and current fixed state by it when rendering.
+        double alpha = 0.0;
+        size_t skippedSystems = 0;
+        size_t idleSystems = 0;
+
+        double deltaSeconds() const noexcept {
+            return std::chrono::duration<double>(delta).count();
+        }
+        double fixedDeltaSeconds() const noexcept {
+            return std::chrono::duration<double>(fixedDelta).count();
+        }
+    };
+
+    /*
+        Run criteria of a registered system, checked right before its batch runs; a system whose condition
+        fails is not scheduled at all and counts as idle (see Universe::GetSystemStats).
+            Changed<Types...>()   a World write (emplace, remove, patch, Destroy, ...) hit one of the pools
+                                  since the system last ran; its own writes do not wake it again
+            Emitted<Event>()      Event was emitted (any polish) since the system last ran
+            EveryNthFrame(n, k)   frames whose number is k modulo n
+            If(fn)                fn() returns true
+        Conditions combine with && and ||. A default-constructed condition always holds.
+
+        Example usage:
+        \code
+        using Cond = LEapsGL::RunCondition;
+        LEapsGL::Universe::registerSystem(new InputSystem(), Cond::Emitted<KeyEvent>() || Cond::EveryNthFrame(30));
+        LEapsGL::Universe::registerSystem(new MatrixSystem(), Cond::Changed<Position, Scale>());
+        \endcode
+    */
+    class RunCondition {
+    public:
+        RunCondition() = default;
+        explicit RunCondition(std::function<bool()> test, std::function<void()> ran = {})
+            : test(std::move(test)), ran(std::move(ran)) {};
+
+        bool holds() const {
+            return !test || test();
+        }
+        // Called once the system ran; stateful criteria remember what they have seen.
+        void commit() const {
+            if (ran) ran();
+        }
+
+        template <typename... Types, typename World>
+        static RunCondition Changed(World& world) {
+            static_assert(sizeof...(Types) > 0, "Changed requires at least one component type.");
+            struct state {
+                std::array<const ContainerBase<typename World::value_type>*, sizeof...(Types)> pools;
+                std::array<std::uint64_t, sizeof...(Types)> seen{};
+            };
+            auto watched = std::make_shared<state>(state{ { &world.template assure<Types>()... } });
+            watched->seen.fill(~std::uint64_t{ 0 }); // never seen: the first check holds
+            return RunCondition(
+                [watched]() {
+                    for (size_t i = 0; i < watched->pools.size(); i++) {
+                        if (watched->pools[i]->change_count() != watched->seen[i]) return true;
+                    }
+                    return false;
+                },
+                [watched]() {
+                    for (size_t i = 0; i < watched->pools.size(); i++) watched->seen[i] = watched->pools[i]->change_count();
+                });
+        }
+        template <typename... Types>
+        static RunCondition Changed();
+        template <typename Event>
+        static RunCondition Emitted();
+        static RunCondition EveryNthFrame(std::uint64_t n, std::uint64_t offset = 0);
+        static RunCondition If(std::function<bool()> fn) {
+            return RunCondition(std::move(fn));
+        }
+
+        friend RunCondition operator&&(const RunCondition& lhs, const RunCondition& rhs) {
+            return RunCondition([lhs, rhs]() { return lhs.holds() && rhs.holds(); }, [lhs, rhs]() { lhs.commit(); rhs.commit(); });
+        }
+        friend RunCondition operator||(const RunCondition& lhs, const RunCondition& rhs) {
+            return RunCondition([lhs, rhs]() { return lhs.holds() || rhs.holds(); }, [lhs, rhs]() { lhs.commit(); rhs.commit(); });
+        }
+
+    private:
+        std::function<bool()> test;
+        std::function<void()> ran;
+    };
+
+    // Per registered system, since registration.
+    struct SystemStats {
+        std::uint64_t runs = 0;
+        std::uint64_t idle = 0;     // RunCondition did not hold
+        std::uint64_t deferred = 0; // LOW priority system skipped over the frame or phase budget
+    };
+
     namespace __internal {
         class RootWorld : public IContext{
         public:
-            ~RootWorld() {};
+            virtual ~RootWorld() {};
+            virtual void swap_buffers() {};
         };
     }
 
+    template<typename Entity, typename Allocator>
+    class Prefab;
+
     template<typename Entity = std::uint64_t, typename Allocator = std::allocator<Entity>>
     class World : public __internal::RootWorld {
     public:
@@ -155,8 +363,11 @@ namespace LEapsGL {
             return entityList.size() - free_entity_num;
         }
         const Entity Create() {
+            if (frozenAll) throw std::logic_error("World: cannot create entities while frozen");
+            entityStamp = __internal::next_membership_stamp();
             if (free_entity_num == 0) {
-                entityList.emplace_back(traits_type::construct(entityList.size(), 0));
+                if (entityList.size() >= traits_type::entity_mask) throw std::length_error("World: entity id space exhausted");
+                entityList.emplace_back(traits_type::construct(static_cast<entity_type>(entityList.size()), retiredVersion));
                 return entityList.back();
             }
             auto next_removed_idx = traits_type::to_entity(entityList[free_entity_id]);
@@ -169,9 +380,15 @@ namespace LEapsGL {
             return entt;
         }
         void Destroy(const Entity& entt){
+            if (frozenAll) throw std::logic_error("World: cannot destroy entities while frozen");
             for (auto& iter : components) {
-                iter.second->remove(entt);
+                if (frozenPools.count(iter.first) && iter.second->contains(entt)) throw std::logic_error("World: entity owns a frozen component");
             }
+            for (auto& iter : components) {
+                if (iter.second->remove(entt)) iter.second->mark_changed();
+            }
+            disabled.reset(entt);
+            entityStamp = __internal::next_membership_stamp();
 
             if (free_entity_num++ > 0) {
                 entityList[traits_type::to_entity(entt)] = traits_type::construct(
@@ -185,13 +402,19 @@ namespace LEapsGL {
 
         template <typename Type>
         void emplace(const Entity& entt) {            
-            static_assert(std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Flag>, "The emplace operation is supported only in FlagContainerType. Please ensure that the container type is set to FlagContainerType."  __MY_PRETTY_FUNCTION_SIGNITURE);
-            this->assure<Type>().emplace(entt);
+            static_assert(std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Flag>, "The emplace operation is supported only in FlagContainerType. Please ensure that the container type is set to FlagContainerType.");
+            this->assureMutable<Type>();
+            auto& pool = this->assure<Type>();
+            pool.emplace(entt);
+            pool.mark_changed();
         }
 
         template <typename Type>
         void emplace(const Entity & entt, traits::to_instance_t<std::decay_t<Type>>&& data) {
-            this->assure<Type>().emplace(entt, std::forward<traits::to_instance_t<std::decay_t<Type>>>(data));
+            this->assureMutable<Type>();
+            auto& pool = this->assure<Type>();
+            pool.emplace(entt, std::forward<traits::to_instance_t<std::decay_t<Type>>>(data));
+            pool.mark_changed();
         }
         template <typename Type>
         void emplace(const Entity& entt, const traits::to_instance_t<std::decay_t<Type>>& data) {
@@ -199,22 +422,94 @@ namespace LEapsGL {
             this->emplace<Type>(entt, std::move(traits::to_instance_t<std::decay_t<Type>>(data)));
         }
 
+        /*
+            Spawn count entities from a prefab. Each involved pool is looked up and grown once.
+        */
+        std::vector<Entity> instantiate(const Prefab<Entity, Allocator>& prefab, const size_t count) {
+            if (frozenAll || !frozenPools.empty()) throw std::logic_error("World: cannot instantiate while frozen");
+            std::vector<Entity> out;
+            out.reserve(count);
+            if (count > free_entity_num) entityList.reserve(entityList.size() + count - free_entity_num);
+            for (size_t i = 0; i < count; i++) out.push_back(Create());
+
+            prefab.spawn(*this, out.data(), count);
+            return out;
+        }
+
         void clear() {
+            if (frozenAll || !frozenPools.empty()) throw std::logic_error("World: cannot clear while frozen");
             for (auto& entt : entityList) Destroy(entt);
+            retireIds(0);
             entityList.clear();
+            entityStamp = __internal::next_membership_stamp();
+            disabled.clear();
+            free_entity_num = 0;
+            free_entity_id = 0;
+        }
+
+        /*
+            Renumber live entities into ids [0, size()) in id order and drop the free list. Every pool rewrites
+            its packed handles and rebuilds its sparse index, so sparse memory follows the live count instead
+            of the historical peak. Moved entities get a version above any handle ever issued for their new id,
+            and ids trimmed off the end are reissued above every version they ever carried, so stale handles
+            never alias a live entity; holders of live handles translate them with the returned table
+            (see also Proxy::remap).
+        */
+        entity_remap<Entity> defragment_ids() {
+            if (frozenAll || !frozenPools.empty()) throw std::logic_error("World: cannot defragment while frozen");
+
+            const std::vector<bool> dead = World::dead_ids(entityList, free_entity_num, free_entity_id);
+
+            entity_remap<Entity> table(entityList.size());
+            vector<Entity, Allocator> compacted;
+            compacted.reserve(entityList.size() - free_entity_num);
+            for (size_t id = 0; id < entityList.size(); id++) {
+                if (dead[id]) continue;
+                const size_t renumbered = compacted.size();
+                const Entity slot = entityList[renumbered];
+                // A dead slot already holds its next version; a live one is bumped past its (moved) owner.
+                const Entity entt = renumbered == id ? entityList[id]
+                    : traits_type::construct(static_cast<entity_type>(renumbered), traits_type::to_version(dead[renumbered] ? slot : traits_type::next_version(slot)));
+                table.set(entityList[id], entt);
+                compacted.push_back(entt);
+            }
+
+            for (auto& iter : components) iter.second->remap(table);
+
+            entity_bitset<Entity> remappedDisabled;
+            for (size_t id = 0; id < entityList.size(); id++) {
+                if (!dead[id] && disabled.test(entityList[id])) remappedDisabled.set(table(entityList[id]));
+            }
+            using std::swap;
+            swap(disabled, remappedDisabled);
+
+            retireIds(compacted.size());
+            entityList.swap(compacted);
+            entityList.shrink_to_fit();
+            entityStamp = __internal::next_membership_stamp();
             free_entity_num = 0;
             free_entity_id = 0;
+            return table;
         }
 
         template <typename Type>
         bool remove(const Entity& entt) {
-            return this->assure<Type>().remove(entt);
+            this->assureMutable<Type>();
+            auto& pool = this->assure<Type>();
+            if (!pool.remove(entt)) return false;
+            pool.mark_changed();
+            return true;
         }
 
         template <typename Type>
         bool contains(const Entity& entt) {
             return this->assure<Type>().contains(entt);
         }
+        // True while entt is alive; false once it was destroyed, even if its id has been recycled.
+        bool valid(const Entity& entt) const {
+            const size_t id = traits_type::to_entity(entt);
+            return id < entityList.size() && entityList[id] == entt;
+        }
 
         static const version_type getEntityVersion(const Entity& entt)  {
             return traits_type::to_version(entt);
@@ -230,45 +525,478 @@ namespace LEapsGL {
             auto iter = components.find(id);
             if (iter != components.end()) return iter->second;
 
+            cloners[id] = &World::clonePool<traits::to_container_t<Type>>;
             return components[id] = std::make_shared<traits::to_container_t<Type>>();
         }
 
+        // Commit every double-buffered pool (Universe::Update does this for registered worlds).
+        void swap_buffers() override {
+            for (auto& iter : components) {
+                if (iter.second) iter.second->swap_buffers();
+            }
+        }
+
+        /*
+            Logical copy of the world for speculative simulation (what-if branches, rollback candidates).
+            Components declaring allocation_type = AllocationType::CopyOnWrite share their component and
+            sparse pages with the original until either side writes one, so forking a world of millions of
+            entities costs one page table per pool and memory grows only with the pages the fork touches.
+            Every other pool, the entity list and the packed arrays are copied. Any mutable access (get(),
+            patch(), a view) counts as a write; read through a const pool to keep pages shared.
+            The fork is never frozen and has no cached frozen views.
+        */
+        World fork() const {
+            World copy;
+            copy.entityList = entityList;
+            copy.free_entity_num = free_entity_num;
+            copy.free_entity_id = free_entity_id;
+            copy.retiredVersion = retiredVersion;
+            copy.disabled = disabled;
+            copy.cloners = cloners;
+            for (const auto& [id, pool] : components) {
+                if (pool) copy.components[id] = cloners.at(id)(*pool);
+            }
+            return copy;
+        }
+
+        /*
+            Rollback ring for rewind and deterministic resimulation.
+            enable_rollback<Types...>(frames) keeps the last `frames` saved states of the listed pools and of the
+            entity list. save_frame() copies each pool's page tables: with
+            allocation_type = AllocationType::CopyOnWrite every component and sparse page stays shared with
+            the live pool, so a saved frame ends up owning only the pages written after it. Packed arrays and
+            the entity list are shared with the previous frame unless their membership changed.
+            restore_frame(k) copies frame k's page tables back into the live pools (references to them stay
+            valid) and forgets every later frame, so the next save_frame() returns k + 1. Pools not listed keep
+            their current values, except that entities which were not alive in frame k are removed from them,
+            so a handle reissued after the restore never inherits components.
+        */
+        template <typename... Types>
+        void enable_rollback(const size_t frames) {
+            static_assert(sizeof...(Types) > 0, "enable_rollback() needs at least one component type.");
+            static_assert((std::is_copy_assignable_v<traits::to_container_t<Types>> && ...), "Rollback requires copyable pools.");
+            if (frames == 0) throw std::length_error("World: rollback needs at least one frame");
+            (this->assure<Types>(), ...);
+            rollbackPools = { rollback_pool{ get_type_hash<Types>(), &World::savePool<traits::to_container_t<Types>>, &World::restorePool<traits::to_container_t<Types>> }... };
+            rollbackRing.clear();
+            rollbackRing.resize(frames);
+            rollbackCount = 0;
+        }
+        // Save the current state; returns its frame number.
+        std::uint64_t save_frame() {
+            if (rollbackRing.empty()) throw std::logic_error("World: rollback is not enabled");
+            const saved_frame* previous = has_frame(nextFrame - 1) ? &rollbackRing[(nextFrame - 1) % rollbackRing.size()] : nullptr;
+            saved_frame& frame = rollbackRing[nextFrame % rollbackRing.size()];
+
+            frame.number = nextFrame;
+            frame.entityStamp = entityStamp;
+            if (previous && previous->entityStamp == entityStamp) frame.entityList = previous->entityList;
+            else frame.entityList = std::make_shared<const vector<Entity, Allocator>>(entityList);
+            frame.free_entity_num = free_entity_num;
+            frame.free_entity_id = free_entity_id;
+            frame.disabled = disabled;
+            frame.pools.resize(rollbackPools.size());
+            for (size_t i = 0; i < rollbackPools.size(); i++) {
+                rollbackPools[i].save(*components.at(rollbackPools[i].id), frame.pools[i], previous ? &previous->pools[i] : nullptr);
+            }
+            rollbackCount = std::min(rollbackCount + 1, rollbackRing.size());
+            return nextFrame++;
+        }
+        bool has_frame(const std::uint64_t number) const noexcept {
+            return number < nextFrame && nextFrame - number <= rollbackCount;
+        }
+        void restore_frame(const std::uint64_t number) {
+            if (frozenAll || !frozenPools.empty()) throw std::logic_error("World: cannot restore a frame while frozen");
+            if (!has_frame(number)) throw std::out_of_range("World: frame is no longer in the rollback ring");
+
+            const saved_frame& frame = rollbackRing[number % rollbackRing.size()];
+            if (entityStamp != frame.entityStamp) {
+                purgeUnsaved(frame);
+                entityList.assign(frame.entityList->begin(), frame.entityList->end());
+            }
+            entityStamp = frame.entityStamp;
+            free_entity_num = frame.free_entity_num;
+            free_entity_id = frame.free_entity_id;
+            disabled = frame.disabled;
+            for (size_t i = 0; i < rollbackPools.size(); i++) rollbackPools[i].restore(*components.at(rollbackPools[i].id), frame.pools[i]);
+
+            rollbackCount -= static_cast<size_t>(nextFrame - number - 1);
+            nextFrame = number + 1;
+        }
+
         template <typename Type>
         auto* get() {
             constexpr size_t id = get_type_hash<Type>();            
+            this->staleFrozen(id);
             return static_cast<traits::to_container_t<Type>*>(components[id].get());
         }
 
-        // Query component type
+        // Query component type (shared components are returned as const)
         template <typename Type>
-        traits::to_instance_t<std::decay_t<Type>>& query(const Entity & entt) {
+        decltype(auto) query(const Entity & entt) {
             return this->get<Type>()->get(entt);
         }
 
+        // Modify a component in place; shared components are copied on write, indexed ones re-keyed and tracked ones marked dirty.
+        template <typename Type, typename Fun>
+        void patch(const Entity& entt, Fun fn) {
+            this->assureMutable<Type>();
+            auto& pool = this->assure<Type>();
+            if constexpr (std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Shared> || __internal::is_indexed_pool<traits::to_container_t<Type>>::value || __internal::is_tracked_pool<traits::to_container_t<Type>>::value) pool.patch(entt, fn);
+            else fn(pool.get(entt));
+            pool.mark_changed();
+        }
+        // Report writes World cannot see (through get(), resource() or a View) to RunCondition::Changed.
+        template <typename Type>
+        void mark_changed() {
+            this->assure<Type>().mark_changed();
+        }
+
+        // Secondary index of an indexed component: find(key), count(key), each_equal(key, fn), each_range(lo, hi, fn).
+        template <typename Type>
+        const auto& index() {
+            static_assert(__internal::is_indexed_pool<traits::to_container_t<Type>>::value, "index() requires a component that declares index_type.");
+            return this->pool<Type>().index();
+        }
+
+        /*
+            World-level resources (ContainerType::Unique)
+        */
+        template <typename Type>
+        traits::to_instance_t<std::decay_t<Type>>& resource() {
+            static_assert(std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Unique>, "resource() requires ContainerType::Unique.");
+            auto& pool = this->assure<Type>();
+            if (!pool.has_value()) throw std::out_of_range("World: resource has not been set");
+            return pool.get();
+        }
+        template <typename Type>
+        traits::to_instance_t<std::decay_t<Type>>& emplace_resource(traits::to_instance_t<std::decay_t<Type>>&& data) {
+            static_assert(std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Unique>, "emplace_resource() requires ContainerType::Unique.");
+            auto& pool = this->assure<Type>();
+            pool.mark_changed();
+            return pool.emplace_resource(std::forward<traits::to_instance_t<std::decay_t<Type>>>(data));
+        }
+        template <typename Type>
+        bool has_resource() {
+            return this->pool<Type>().has_value();
+        }
+
+        // Mutable access to the pool; cached frozen views over it are rebuilt on their next frozen() call.
         template <typename Type>
         auto& assure() {
-            constexpr size_t id = get_type_hash<Type>();
-            return *static_cast<traits::to_container_t<Type>*>(this->assureComponent<Type>().get());
+            this->staleFrozen(get_type_hash<Type>());
+            return this->pool<Type>();
         }
 
         template <typename... Types, typename... FilterType>
         View<W_ComponentPool<traits::to_container_t<Types>...>, Filter<traits::to_container_t<FilterType>...>> view(Filter<FilterType...> tmp = Filter<>{}) {
-            static_assert((std::is_same_v<Entity, traits::to_entity_t<Types>> && ...), ": All types within the View must be associated with the same entity system." 
-                ">>>Class Information: "
-                __FUNCTION__
-                ">>>Function Information "
-                __MY_PRETTY_FUNCTION_SIGNITURE);
+            return this->view<Types...>(tmp, IncludeDisabled{}).skip(&disabled);
+        }
+        template <typename... Types>
+        View<W_ComponentPool<traits::to_container_t<Types>...>, Filter<>> view(IncludeDisabled) {
+            return this->view<Types...>(Filter<>{}, IncludeDisabled{});
+        }
+        template <typename... Types, typename... FilterType>
+        View<W_ComponentPool<traits::to_container_t<Types>...>, Filter<traits::to_container_t<FilterType>...>> view(Filter<FilterType...>, IncludeDisabled) {
+            static_assert((std::is_same_v<Entity, traits::to_entity_t<Types>> && ...), ": All types within the View must be associated with the same entity system.");
             return { &this->assure<std::remove_const_t<Types>>()... ,  &this->assure<std::remove_const_t<FilterType>>()... };
         }
 
+        /*
+            Disabled entities keep all their components but are skipped by every view (and so by
+            frozen snapshots, which are rebuilt on their next frozen() call). Toggling is one bit; no pool is touched.
+        */
+        void disable(const Entity& entt) {
+            disabled.set(entt);
+            this->staleFrozen();
+        }
+        void enable(const Entity& entt) {
+            disabled.reset(entt);
+            this->staleFrozen();
+        }
+        bool is_enabled(const Entity& entt) const noexcept {
+            return !disabled.test(entt);
+        }
+        size_t disabled_count() const noexcept {
+            return disabled.count();
+        }
+
+        /*
+            Frozen mode for static data.
+            freeze() locks the whole world, freeze<Types...>() only the listed pools. Frozen pools drop their
+            spare capacity and reject emplace/remove/patch (std::logic_error) but keep their layout;
+            frozen<Types...>() serves a FrozenView: entities renumbered densely and components copied into
+            contiguous arrays. The snapshot of each query is built on first use and cached until unfreeze().
+            Values can still be written through get(), assure(), resource() or a view, and disable()/enable()
+            change what a view matches; each of these marks the cached snapshots it may affect stale, and
+            frozen() rebuilds a stale snapshot in place, so references to it stay valid.
+        */
+        template <typename... Types>
+        void freeze() {
+            if constexpr (sizeof...(Types) == 0) {
+                frozenAll = true;
+                for (auto& iter : components) iter.second->shrink_to_fit();
+                entityList.shrink_to_fit();
+            }
+            else {
+                (this->freezePool<Types>(), ...);
+            }
+        }
+        void unfreeze() {
+            frozenAll = false;
+            frozenPools.clear();
+            frozenViews.clear();
+        }
+        template <typename Type>
+        bool is_frozen() const {
+            return frozenAll || frozenPools.count(get_type_hash<Type>()) > 0;
+        }
+
+        template <typename... Types>
+        const FrozenView<Entity, Types...>& frozen() {
+            static_assert(sizeof...(Types) > 0, "frozen() needs at least one component type.");
+            if (!(this->is_frozen<Types>() && ...)) throw std::logic_error("World: frozen() requires every queried pool to be frozen");
+
+            constexpr size_t id = get_type_hash<FrozenView<Entity, Types...>>();
+            auto iter = frozenViews.find(id);
+            if (iter != frozenViews.end() && !iter->second.stale) return *static_cast<const FrozenView<Entity, Types...>*>(iter->second.view.get());
+
+            // Read through pool() so building one snapshot does not mark the others stale.
+            std::vector<Entity> matched;
+            View<W_ComponentPool<traits::to_container_t<Types>...>, Filter<>> matching{ &this->pool<Types>()... };
+            for (auto entt : matching.skip(&disabled)) matched.push_back(entt);
+            FrozenView<Entity, Types...> snapshot(std::move(matched), &this->pool<Types>()...);
+            if (iter != frozenViews.end()) {
+                auto& cached = *static_cast<FrozenView<Entity, Types...>*>(iter->second.view.get());
+                cached = std::move(snapshot);
+                iter->second.stale = false;
+                return cached;
+            }
+            auto cached = std::make_shared<FrozenView<Entity, Types...>>(std::move(snapshot));
+            frozenViews[id] = frozen_view{ cached, { get_type_hash<Types>()... }, false };
+            return *cached;
+        }
+
     private:
+        // Pool copy without its packed array, which is kept separately so unchanged frames can share it.
+        struct saved_pool {
+            ComponentPtr pool;
+            std::shared_ptr<const void> packed;
+        };
+        struct rollback_pool {
+            size_t id;
+            void (*save)(ContainerBase<Entity>&, saved_pool&, const saved_pool*);
+            void (*restore)(ContainerBase<Entity>&, const saved_pool&);
+        };
+        struct saved_frame {
+            std::uint64_t number = 0;
+            std::uint64_t entityStamp = 0;
+            std::shared_ptr<const vector<Entity, Allocator>> entityList;
+            size_t free_entity_num = 0;
+            size_t free_entity_id = 0;
+            entity_bitset<Entity> disabled;
+            std::vector<saved_pool> pools; // parallel to rollbackPools
+        };
+
+        // Raise retiredVersion past every handle issued for the ids from `from` on, which are about to be dropped.
+        void retireIds(const size_t from) {
+            // A free slot already holds its next version; bumping it once more is harmless.
+            for (size_t id = from; id < entityList.size(); id++) {
+                retiredVersion = std::max(retiredVersion, traits_type::to_version(traits_type::next_version(entityList[id])));
+            }
+        }
+        // Ids on the free list of an entity list.
+        static std::vector<bool> dead_ids(const vector<Entity, Allocator>& list, const size_t freeNum, const size_t freeId) {
+            std::vector<bool> dead(list.size(), false);
+            for (size_t i = 0, id = freeId; i < freeNum; i++) {
+                dead[id] = true;
+                id = static_cast<size_t>(traits_type::to_entity(list[id]));
+            }
+            return dead;
+        }
+        // Remove entities that were not alive in frame from the pools rollback does not restore.
+        void purgeUnsaved(const saved_frame& frame) {
+            const auto& saved = *frame.entityList;
+            const std::vector<bool> deadNow = World::dead_ids(entityList, free_entity_num, free_entity_id);
+            const std::vector<bool> deadThen = World::dead_ids(saved, frame.free_entity_num, frame.free_entity_id);
+            for (size_t id = 0; id < entityList.size(); id++) {
+                if (deadNow[id]) continue;
+                const Entity entt = entityList[id];
+                if (id < saved.size() && !deadThen[id] && saved[id] == entt) continue;
+                for (auto& [poolId, pool] : components) {
+                    const bool restored = std::any_of(rollbackPools.begin(), rollbackPools.end(), [poolId = poolId](const rollback_pool& r) { return r.id == poolId; });
+                    if (!restored && pool && pool->remove(entt)) pool->mark_changed();
+                }
+            }
+        }
+
+        template <typename Pool>
+        static void savePool(ContainerBase<Entity>& base, saved_pool& out, const saved_pool* previous) {
+            using packed_type = decltype(Pool::packed);
+            auto& pool = static_cast<Pool&>(base);
+
+            packed_type packed = std::move(pool.packed);
+            out.pool = std::make_shared<Pool>(pool);
+            pool.packed = std::move(packed);
+
+            if (previous && static_cast<const Pool&>(*previous->pool).membership_stamp() == pool.membership_stamp()) out.packed = previous->packed;
+            else out.packed = std::make_shared<const packed_type>(pool.packed);
+        }
+        template <typename Pool>
+        static void restorePool(ContainerBase<Entity>& base, const saved_pool& saved) {
+            using packed_type = decltype(Pool::packed);
+            auto& pool = static_cast<Pool&>(base);
+            const auto& savedPool = static_cast<const Pool&>(*saved.pool);
+
+            packed_type packed = std::move(pool.packed);
+            if (pool.membership_stamp() != savedPool.membership_stamp()) {
+                const auto& savedPacked = *static_cast<const packed_type*>(saved.packed.get());
+                packed.assign(savedPacked.begin(), savedPacked.end());
+            }
+            pool = savedPool;
+            pool.packed = std::move(packed);
+        }
+        template <typename Pool>
+        static ComponentPtr clonePool(const ContainerBase<Entity>& pool) {
+            if constexpr (std::is_copy_constructible_v<Pool>) return std::make_shared<Pool>(static_cast<const Pool&>(pool));
+            else throw std::logic_error("World: component pool cannot be forked");
+        }
+        template <typename Type>
+        auto& pool() {
+            return *static_cast<traits::to_container_t<Type>*>(this->assureComponent<Type>().get());
+        }
+        // Mark the cached frozen views over component id (or all of them) for rebuilding.
+        void staleFrozen(const size_t id) {
+            for (auto& [key, cached] : frozenViews) {
+                if (std::find(cached.types.begin(), cached.types.end(), id) != cached.types.end()) cached.stale = true;
+            }
+        }
+        void staleFrozen() {
+            for (auto& [key, cached] : frozenViews) cached.stale = true;
+        }
+        template <typename Type>
+        void assureMutable() const {
+            if (this->is_frozen<Type>()) throw std::logic_error("World: component pool is frozen");
+        }
+        template <typename Type>
+        void freezePool() {
+            this->assure<Type>().shrink_to_fit();
+            frozenPools.insert(get_type_hash<Type>());
+        }
+
         vector<Entity, Allocator> entityList;
         unordered_map<size_t, ComponentPtr> components;
-        size_t free_entity_num;
-        size_t free_entity_id;
+        unordered_map<size_t, ComponentPtr(*)(const ContainerBase<Entity>&)> cloners;
+
+        std::uint64_t entityStamp = 0; // see packed_set::membership_stamp
+        std::vector<rollback_pool> rollbackPools;
+        std::vector<saved_frame> rollbackRing;
+        size_t rollbackCount = 0;
+        std::uint64_t nextFrame = 0;
+        size_t free_entity_num = 0;
+        size_t free_entity_id = 0;
+        version_type retiredVersion = 0; // first version for ids at or above entityList.size()
+
+        entity_bitset<Entity> disabled;
+
+        bool frozenAll = false;
+        std::unordered_set<size_t> frozenPools;
+        struct frozen_view {
+            std::shared_ptr<void> view;
+            std::vector<size_t> types;
+            bool stale = false;
+        };
+        unordered_map<size_t, frozen_view> frozenViews;
+    };
+
+    /**
+     * @brief Captured component set used to spawn many identical entities.
+     *
+     * Example usage:
+     * \code
+     * LEapsGL::Prefab<> particle;
+     * particle.set<Position>(glm::vec3(0.0f)).set<Velocity>(glm::vec3(0.0f, 1.0f, 0.0f)).set<Alive>();
+     * auto entities = world.instantiate(particle, 10000);
+     * \endcode
+     */
+    template<typename Entity = std::uint64_t, typename Allocator = std::allocator<Entity>>
+    class Prefab {
+    public:
+        using world_type = World<Entity, Allocator>;
+
+        template <typename Type>
+        Prefab& set(traits::to_instance_t<std::decay_t<Type>> value) {
+            static_assert(!std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Unique>, "Unique components cannot be part of a prefab.");
+            static_assert(!std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Flag>, "Flag components are set with set<Type>().");
+            return this->put(get_type_hash<Type>(), std::make_shared<ComponentTemplate<Type>>(std::move(value)));
+        }
+        template <typename Type>
+        Prefab& set() {
+            static_assert(std::is_same_v<typename traits::to_container_meta_t<Type>, ContainerType::Flag>, "set<Type>() without a value is supported only for ContainerType::Flag.");
+            return this->put(get_type_hash<Type>(), std::make_shared<FlagTemplate<Type>>());
+        }
+        template <typename Type>
+        Prefab& unset() {
+            const size_t id = get_type_hash<Type>();
+            components.erase(std::remove_if(components.begin(), components.end(), [id](const auto& c) { return c->id == id; }), components.end());
+            return *this;
+        }
+
+        size_t size() const {
+            return components.size();
+        }
+
+        void spawn(world_type& world, const Entity* first, const size_t count) const {
+            for (const auto& component : components) component->spawn(world, first, count);
+        }
+
+    private:
+        struct ComponentTemplateBase {
+            virtual ~ComponentTemplateBase() {};
+            virtual void spawn(world_type& world, const Entity* first, const size_t count) const = 0;
+            size_t id = 0;
+        };
+        template <typename Type>
+        struct ComponentTemplate : public ComponentTemplateBase {
+            ComponentTemplate(traits::to_instance_t<std::decay_t<Type>>&& v) : value(std::move(v)) {};
+            virtual void spawn(world_type& world, const Entity* first, const size_t count) const override {
+                auto& pool = world.template assure<Type>();
+                pool.emplace_n(first, count, value);
+                pool.mark_changed();
+            }
+            traits::to_instance_t<std::decay_t<Type>> value;
+        };
+        template <typename Type>
+        struct FlagTemplate : public ComponentTemplateBase {
+            virtual void spawn(world_type& world, const Entity* first, const size_t count) const override {
+                auto& pool = world.template assure<Type>();
+                pool.emplace_n(first, count);
+                pool.mark_changed();
+            }
+        };
+
+        Prefab& put(const size_t id, std::shared_ptr<ComponentTemplateBase> component) {
+            component->id = id;
+            for (auto& c : components) {
+                if (c->id == id) {
+                    c = std::move(component);
+                    return *this;
+                }
+            }
+            components.push_back(std::move(component));
+            return *this;
+        }
+
+        // Shared so copies of a prefab are cheap; set() replaces entries instead of mutating them.
+        std::vector<std::shared_ptr<const ComponentTemplateBase>> components;
     };
 
     using BaseWorld = LEapsGL::World<LEapsGL::BaseEntityType>;
+    /*
+        Compact world: 4-byte sparse/packed entries for worlds that stay under 1M entities.
+        Components join it by declaring `using entity_type = LEapsGL::CompactEntityType;`.
+    */
+    using CompactWorld = LEapsGL::World<LEapsGL::CompactEntityType>;
 
     namespace traits {
         template <typename ComponentType>
@@ -280,9 +1008,60 @@ namespace LEapsGL {
     public:
         using BaseEntityType = LEapsGL::BaseEntityType;
 
+        /*
+                Instances
+            The static API works on the Universe bound to the calling thread, or on the process-wide one when
+            none is bound. CreateInstance() makes an isolated universe with its own worlds and context objects
+            (Context), systems, events, timers, coroutines and proxy caches; bind it with a Scope on the thread
+            that drives it. Instances share nothing, so N threads can each drive their own instance.
+
+            Example usage:
+            \code
+            std::vector<std::thread> threads;
+            for (int i = 0; i < N; i++) threads.emplace_back([] {
+                auto sim = LEapsGL::Universe::CreateInstance();
+                LEapsGL::Universe::Scope bound(*sim);
+                LEapsGL::Universe::registerSystem(new PhysicsSystem());
+                for (int frame = 0; frame < 1000; frame++) LEapsGL::Universe::Update(16);
+            });
+            \endcode
+        */
+        static Universe& get_instance() {
+            return current ? *current : Singleton<Universe>::get_instance();
+        }
+        // workers: threads of the instance's own system scheduler (see SetWorkerCount).
+        static std::unique_ptr<Universe> CreateInstance(const size_t workers = 0) {
+            std::unique_ptr<Universe> univ(new Universe());
+            univ->context = Context::CreateInstance();
+            univ->workers.resize(workers);
+            return univ;
+        }
+        ~Universe() {
+#ifdef LEAPS_COROUTINES_AVAILABLE
+            for (auto& coroutine : coroutines) coroutine.second.destroy();
+#endif
+        }
+
+        // Binds univ (and its Context) to the calling thread until the scope ends; scopes nest.
+        class Scope {
+        public:
+            explicit Scope(Universe& univ) noexcept : context(univ.context.get()), previous(std::exchange(current, &univ)) {};
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            ~Scope() {
+                current = previous;
+            }
+        private:
+            Context::Scope context;
+            Universe* previous;
+        };
+
         static inline LEapsGL::BaseWorld& GetBaseWorld() {
             return Universe::get_instance().baseWorld;
         }
+        static inline LEapsGL::CompactWorld& GetCompactWorld() {
+            return Context::getGlobalContext<LEapsGL::CompactWorld>();
+        }
 
         template<typename... Types>
         static auto& GetRelativeWorld() {
@@ -293,7 +1072,7 @@ namespace LEapsGL {
 
         template<typename... Types>
         static auto View() {
-            return Universe::GetRelativeWorld<Types...>().view<Types...>();
+            return Universe::GetRelativeWorld<Types...>().template view<Types...>();
         }
 
         template<typename World>
@@ -301,6 +1080,20 @@ namespace LEapsGL {
             return Context::getGlobalContext<World>();
         }
 
+        // Double-buffered pools of registered worlds are committed at the end of every Update (the base world always is).
+        template<typename Entity, typename Allocator = std::allocator<Entity>>
+        static void RegisterBufferedWorld() {
+            Universe::RegisterBufferedWorld(Context::getGlobalContext<World<Entity, Allocator>>());
+        }
+        static void RegisterBufferedWorld(__internal::RootWorld& world) {
+            auto& buffered = Universe::get_instance().bufferedWorlds;
+            if (std::find(buffered.begin(), buffered.end(), &world) == buffered.end()) buffered.push_back(&world);
+        }
+        static void UnregisterBufferedWorld(__internal::RootWorld& world) {
+            auto& buffered = Universe::get_instance().bufferedWorlds;
+            buffered.erase(std::remove(buffered.begin(), buffered.end(), &world), buffered.end());
+        }
+
         template<typename Entity, typename Allocator = std::allocator<Entity>>
         static void RegisterSerializableWorld() {
             constexpr size_t id = get_type_hash<Entity>();
@@ -335,15 +1128,51 @@ namespace LEapsGL {
             const Event event;
         };
 
-        static void registerSystem(BaseSystem* sys) {
+        /*
+            Systems without SystemAccess run alone, in registration order. A system that declares its access
+            (ParallelSystem) goes into the first batch after every earlier-registered system it conflicts with,
+            i.e. the batches are the layers of the dependency DAG. Batches run one after another; the systems of
+            a batch run concurrently on the worker pool, and their queued events are delivered per system in
+            registration order once the batch is done.
+        */
+        static std::vector<std::vector<BaseSystem*>> ScheduleSystems(const std::vector<BaseSystem*>& systems) {
+            std::vector<size_t> level(systems.size(), 0);
+            size_t levels = 0;
+            for (size_t j = 0; j < systems.size(); j++) {
+                const SystemAccess* access = systems[j]->Access();
+                for (size_t i = 0; i < j; i++) {
+                    const SystemAccess* earlier = systems[i]->Access();
+                    if (!access || !earlier || access->conflicts(*earlier)) level[j] = std::max(level[j], level[i] + 1);
+                }
+                levels = std::max(levels, level[j] + 1);
+            }
+            std::vector<std::vector<BaseSystem*>> batches(levels);
+            for (size_t j = 0; j < systems.size(); j++) batches[level[j]].push_back(systems[j]);
+            return batches;
+        }
+        // Worker threads besides the one calling Update (0 runs every system on the calling thread).
+        static void SetWorkerCount(const size_t workers) {
+            Universe::get_instance().workers.resize(workers);
+        }
+
+        static void registerSystem(BaseSystem* sys, const FramePhase phase = FramePhase::UPDATE, const SystemPriority priority = SystemPriority::NORMAL) {
+            Universe::registerSystem(sys, RunCondition{}, phase, priority);
+        }
+        static void registerSystem(BaseSystem* sys, RunCondition condition, const FramePhase phase = FramePhase::UPDATE, const SystemPriority priority = SystemPriority::NORMAL) {
             sys->Configure();
-            Universe::get_instance().systemList.push_back(sys);
+            Universe::get_instance().systemList.emplace_back(sys, phase, priority, std::move(condition));
+        }
+        static const SystemStats& GetSystemStats(const BaseSystem* system) {
+            for (const auto& entry : Universe::get_instance().systemList) {
+                if (entry.system == system) return entry.stats;
+            }
+            throw std::out_of_range("Universe: system is not registered");
         }
 
         static void unregisterSystem(BaseSystem* system)
         {
             auto& univ = Universe::get_instance();
-            univ.systemList.erase(std::remove(univ.systemList.begin(), univ.systemList.end(), system), univ.systemList.end());
+            univ.systemList.erase(std::remove_if(univ.systemList.begin(), univ.systemList.end(), [system](const RegisteredSystem& entry) { return entry.system == system; }), univ.systemList.end());
             system->Unconfigure();
         }
 
@@ -391,43 +1220,613 @@ namespace LEapsGL {
         template <typename Event, EventPolish Polish = EventPolish::DIRECT>
         static void emit(const Event& event) {
             auto& univ = Universe::get_instance();
+            if (!univ.emitted.empty()) {
+                auto counter = univ.emitted.find(get_type_hash<Event>()); // filled by RunCondition::Emitted only
+                if (counter != univ.emitted.end()) counter->second.fetch_add(1, std::memory_order_relaxed);
+            }
 
             if constexpr (Polish == EventPolish::DIRECT) {
                 constexpr size_t id = get_type_hash<Event>();
-                for (auto* base : univ.subscribers[id]) {
+                auto iter = univ.subscribers.find(id); // no insertion: parallel systems may emit concurrently
+                if (iter == univ.subscribers.end()) return;
+                for (auto* base : iter->second) {
                     auto* sub = reinterpret_cast<EventSubscriber<Event>*>(base);
                     sub->receive(event);
                 }
             }
             else {
                 auto dispatcher = std::make_shared<UniverseDispatcher<Event>>(event);
-                univ.eventQueue.emplace<TO_TYPE<Polish>>(dispatcher);
+                (stagedEvents ? *stagedEvents : univ.eventQueue).template emplace<TO_TYPE<Polish>>(dispatcher);
+            }
+        }
+
+        /*
+                Timers
+            Delays are counted in frames (one per Update) or in milliseconds of Update-to-Update time.
+            Expired timers run at the start of Update, before any system; Polish defers the callback
+            to the matching event queue instead.
+
+            Example usage:
+            \code
+            auto& world = LEapsGL::Universe::GetBaseWorld();
+            LEapsGL::Universe::destroyAfter(world, bullet, LEapsGL::TimerClock::MILLISECOND, 3000);
+            LEapsGL::Universe::removeAfter<Stunned>(world, player, LEapsGL::TimerClock::FRAME, 30);
+            auto h = LEapsGL::Universe::emitAfter<RespawnEvent, LEapsGL::EventPolish::AFTER_UPDATE>(RespawnEvent{ player }, LEapsGL::TimerClock::FRAME, 120);
+            LEapsGL::Universe::cancelTimer(h);
+            \endcode
+        */
+        struct TimerHandle {
+            TimerWheel::handle handle;
+            TimerClock clock = TimerClock::FRAME;
+        };
+
+        template <EventPolish Polish = EventPolish::DIRECT>
+        static TimerHandle schedule(const TimerClock clock, const TimerWheel::tick_type delay, std::function<void()> fn) {
+            auto& univ = Universe::get_instance();
+            auto& wheel = clock == TimerClock::FRAME ? univ.frameTimers : univ.clockTimers;
+
+            if constexpr (Polish == EventPolish::DIRECT) {
+                return TimerHandle{ wheel.schedule(delay, std::move(fn)), clock };
+            }
+            else {
+                return TimerHandle{ wheel.schedule(delay, [fn = std::move(fn)]() {
+                    Universe::get_instance().eventQueue.emplace<TO_TYPE<Polish>>(std::make_shared<CallbackDispatcher>(fn));
+                }), clock };
+            }
+        }
+        static bool cancelTimer(const TimerHandle& timer) {
+            auto& univ = Universe::get_instance();
+            return (timer.clock == TimerClock::FRAME ? univ.frameTimers : univ.clockTimers).cancel(timer.handle);
+        }
+
+        // Destroy entt unless it was already destroyed (a recycled id is left alone).
+        template <EventPolish Polish = EventPolish::DIRECT, typename World>
+        static TimerHandle destroyAfter(World& world, const typename World::value_type entt, const TimerClock clock, const TimerWheel::tick_type delay) {
+            return Universe::schedule<Polish>(clock, delay, [&world, entt]() {
+                if (world.valid(entt)) world.Destroy(entt);
+            });
+        }
+        template <typename Type, EventPolish Polish = EventPolish::DIRECT, typename World>
+        static TimerHandle removeAfter(World& world, const typename World::value_type entt, const TimerClock clock, const TimerWheel::tick_type delay) {
+            return Universe::schedule<Polish>(clock, delay, [&world, entt]() {
+                if (world.valid(entt)) world.template remove<Type>(entt);
+            });
+        }
+        // Polish applies once the timer expires, exactly as for emit.
+        template <typename Event, EventPolish Polish = EventPolish::DIRECT>
+        static TimerHandle emitAfter(const Event& event, const TimerClock clock, const TimerWheel::tick_type delay) {
+            return Universe::schedule(clock, delay, [event]() {
+                Universe::emit<Event, Polish>(event);
+            });
+        }
+
+#ifdef LEAPS_COROUTINES_AVAILABLE
+        /*
+                Coroutines
+            Awaitables of a Coroutine (see Coroutine.h). Suspended coroutines are resumed by Update / Frame
+            right after the timers, before any system, in the order they became ready; at most
+            FrameSettings::maxCoroutineResumes per frame.
+                NextFrame()         the next Update
+                WaitFrames(n)       the n-th Update from now
+                WaitFor(ms)         the first Update after ms milliseconds of Update-to-Update time
+                WaitEvent<Event>()  the Update after Event was emitted; co_await yields the event
+                Async(fn)           the first Update after fn finished on its own thread; co_await yields
+                                    fn's result or rethrows its exception
+            Start, stop and await from the thread calling Update or from systems that run alone.
+        */
+        static CoroutineHandle StartCoroutine(Coroutine coroutine) {
+            auto& univ = Universe::get_instance();
+            const auto handle = coroutine.release();
+            if (!handle) throw std::invalid_argument("Universe: coroutine was already started");
+
+            CoroutineHandle started;
+            {
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                started.id = handle.promise().id = ++univ.lastCoroutine;
+                univ.coroutines.emplace(started.id, handle);
+            }
+            Universe::ResumeCoroutine(started.id, handle);
+            return started;
+        }
+        // Destroys a suspended coroutine; false if it already finished. An Async job it waits for is still joined.
+        static bool StopCoroutine(const CoroutineHandle coroutine) {
+            auto& univ = Universe::get_instance();
+            if (coroutine.id != 0 && univ.runningCoroutine == coroutine.id) throw std::logic_error("Universe: a coroutine cannot stop itself; co_return instead");
+
+            Coroutine::handle_type handle;
+            {
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                auto iter = univ.coroutines.find(coroutine.id);
+                if (iter == univ.coroutines.end()) return false;
+                handle = iter->second;
+                univ.coroutines.erase(iter);
+                for (auto& waiter : univ.eventWaiters) waiter.second->cancel(coroutine.id);
+                univ.coroutineJobs.erase(std::remove_if(univ.coroutineJobs.begin(), univ.coroutineJobs.end(), [&coroutine](const CoroutineJob& job) { return job.id == coroutine.id; }), univ.coroutineJobs.end());
+            }
+            handle.destroy();
+            return true;
+        }
+        static bool IsCoroutineRunning(const CoroutineHandle coroutine) {
+            auto& univ = Universe::get_instance();
+            std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+            return univ.coroutines.count(coroutine.id) != 0;
+        }
+
+        struct NextFrameAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(const Coroutine::handle_type handle) const {
+                auto& univ = Universe::get_instance();
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                univ.nextFrameCoroutines.push_back(handle.promise().id);
+            }
+            void await_resume() const noexcept {}
+        };
+        struct TimerAwaiter {
+            TimerClock clock;
+            TimerWheel::tick_type delay;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(const Coroutine::handle_type handle) const {
+                Universe::schedule(clock, delay, [id = handle.promise().id]() {
+                    Universe::MarkCoroutineReady(id);
+                });
+            }
+            void await_resume() const noexcept {}
+        };
+        template <typename Event>
+        struct EventAwaiter {
+            std::optional<Event> event;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(const Coroutine::handle_type handle) {
+                auto& univ = Universe::get_instance();
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                univ.assureEventWaiter<Event>().waiting.emplace_back(handle.promise().id, &event);
+            }
+            Event await_resume() {
+                return std::move(*event);
+            }
+        };
+        template <typename Fn>
+        struct AsyncAwaiter {
+            using result_type = std::invoke_result_t<Fn>;
+            Fn fn;
+            std::future<result_type> result;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(const Coroutine::handle_type handle) {
+                auto& univ = Universe::get_instance();
+                result = std::async(std::launch::async, [&univ, fn = std::move(fn)]() mutable {
+                    Scope bound(univ);
+                    return fn();
+                });
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                univ.coroutineJobs.push_back(CoroutineJob{ handle.promise().id, [future = &result]() {
+                    return future->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                } });
             }
+            result_type await_resume() {
+                return result.get();
+            }
+        };
+
+        static NextFrameAwaiter NextFrame() {
+            return {};
+        }
+        static TimerAwaiter WaitFrames(const TimerWheel::tick_type frames) {
+            return TimerAwaiter{ TimerClock::FRAME, frames };
+        }
+        static TimerAwaiter WaitFor(const TimerWheel::tick_type milliseconds) {
+            return TimerAwaiter{ TimerClock::MILLISECOND, milliseconds };
+        }
+        template <typename Event>
+        static EventAwaiter<Event> WaitEvent() {
+            return {};
         }
+        template <typename Fn>
+        static AsyncAwaiter<std::decay_t<Fn>> Async(Fn&& fn) {
+            return AsyncAwaiter<std::decay_t<Fn>>{ std::forward<Fn>(fn) };
+        }
+#endif
 
         // System Releationship
         // 
         // Updates
         static void Update() {
             auto& univ = Universe::get_instance();
+            const auto now = std::chrono::steady_clock::now();
+            const auto elapsed = univ.lastUpdate ? std::chrono::duration_cast<std::chrono::milliseconds>(now - *univ.lastUpdate).count() : 0;
+            univ.lastUpdate = now;
+            Universe::Update(static_cast<TimerWheel::tick_type>(elapsed));
+        }
+        // Deterministic step: the millisecond clock advances by exactly elapsedMilliseconds.
+        // Runs only the UPDATE phase; Frame() drives every phase.
+        static void Update(const TimerWheel::tick_type elapsedMilliseconds) {
+            auto& univ = Universe::get_instance();
+            univ.frameStart = std::chrono::steady_clock::now();
+            univ.frameTime.frame++;
+            univ.frameTime.skippedSystems = 0;
+            univ.frameTime.idleSystems = 0;
+
+            univ.frameTimers.advance(1);
+            univ.clockTimers.advance(elapsedMilliseconds);
+#ifdef LEAPS_COROUTINES_AVAILABLE
+            Universe::ResumeCoroutines();
+#endif
+
+            Universe::RunPhase(FramePhase::UPDATE);
+            Universe::EndUpdate();
+        }
 
-            for (auto sys : univ.systemList) {
-                sys->Update();
-                univ.eventQueue.sendAll<TO_TYPE<EventPolish::AFTER_SYSTEM>>();
+        /*
+            Engine frame on the monotonic clock:
+                timers -> INPUT -> FIXED_UPDATE x n -> UPDATE -> LATE_UPDATE -> AFTER_UPDATE events
+                -> double-buffer commit -> RENDER
+            FIXED_UPDATE runs once per whole fixed step in the accumulator, at most maxFixedSteps times; the
+            remainder becomes GetFrameTime().alpha for interpolation. Once the frame has spent its budget, or
+            a phase its phaseBudgets entry, LOW priority systems are skipped until they have been deferred
+            maxDeferredFrames times.
+        */
+        static void Frame() {
+            auto& univ = Universe::get_instance();
+            const auto now = std::chrono::steady_clock::now();
+            const auto elapsed = univ.lastUpdate ? now - *univ.lastUpdate : std::chrono::steady_clock::duration::zero();
+            univ.lastUpdate = now;
+            Universe::Frame(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+        }
+        // Deterministic frame of exactly `elapsed`.
+        static void Frame(const std::chrono::nanoseconds elapsed) {
+            auto& univ = Universe::get_instance();
+            univ.frameStart = std::chrono::steady_clock::now();
+
+            FrameTime& time = univ.frameTime;
+            time.frame++;
+            time.delta = elapsed;
+            time.fixedDelta = univ.fixedDelta();
+            time.fixedSteps = 0;
+            time.skippedSystems = 0;
+            time.idleSystems = 0;
+
+            // The millisecond clock keeps the sub-millisecond remainder for the next frame.
+            univ.millisecondCarry += elapsed;
+            const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(univ.millisecondCarry);
+            univ.millisecondCarry -= milliseconds;
+            univ.frameTimers.advance(1);
+            univ.clockTimers.advance(static_cast<TimerWheel::tick_type>(milliseconds.count()));
+#ifdef LEAPS_COROUTINES_AVAILABLE
+            Universe::ResumeCoroutines();
+#endif
+
+            Universe::RunPhase(FramePhase::INPUT);
+
+            univ.accumulator += elapsed;
+            while (univ.accumulator >= time.fixedDelta && time.fixedSteps < univ.frameSettings.maxFixedSteps) {
+                Universe::RunPhase(FramePhase::FIXED_UPDATE);
+                univ.accumulator -= time.fixedDelta;
+                time.fixedSteps++;
             }
-            univ.eventQueue.sendAll<TO_TYPE<EventPolish::AFTER_UPDATE>>();
+            if (univ.accumulator >= time.fixedDelta) univ.accumulator %= time.fixedDelta;
+            time.alpha = static_cast<double>(univ.accumulator.count()) / static_cast<double>(time.fixedDelta.count());
+
+            Universe::RunPhase(FramePhase::UPDATE);
+            Universe::RunPhase(FramePhase::LATE_UPDATE);
+            Universe::EndUpdate();
+            Universe::RunPhase(FramePhase::RENDER);
         }
+
+        static void SetFrameSettings(const FrameSettings& settings) {
+            if (!(settings.fixedHz > 0.0)) throw std::invalid_argument("Universe: fixedHz must be positive");
+            Universe::get_instance().frameSettings = settings;
+        }
+        static const FrameSettings& GetFrameSettings() {
+            return Universe::get_instance().frameSettings;
+        }
+        static const FrameTime& GetFrameTime() {
+            return Universe::get_instance().frameTime;
+        }
+
     private:
+        std::chrono::nanoseconds fixedDelta() const {
+            return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(1e9 / frameSettings.fixedHz));
+        }
+        bool overBudget(const FramePhase phase) const {
+            const auto phaseBudget = frameSettings.phaseBudgets[static_cast<size_t>(phase)];
+            if (frameSettings.budget.count() <= 0 && phaseBudget.count() <= 0) return false;
+            const auto now = std::chrono::steady_clock::now();
+            return (frameSettings.budget.count() > 0 && now - frameStart > frameSettings.budget)
+                || (phaseBudget.count() > 0 && now - phaseStart > phaseBudget);
+        }
+        auto* find(const BaseSystem* system) {
+            decltype(&systemList.front()) found = nullptr;
+            for (auto& entry : systemList) {
+                if (entry.system == system) return found = &entry;
+            }
+            return found;
+        }
+        // False if the system should not run now: its RunCondition fails, or it is LOW and the frame is over budget.
+        bool admit(BaseSystem* system) {
+            auto* entry = find(system);
+            if (!entry) return true;
+            if (!entry->condition.holds()) {
+                entry->stats.idle++;
+                frameTime.idleSystems++;
+                return false;
+            }
+            if (entry->priority == SystemPriority::LOW && entry->deferredFrames < frameSettings.maxDeferredFrames && overBudget(entry->phase)) {
+                entry->deferredFrames++;
+                entry->stats.deferred++;
+                frameTime.skippedSystems++;
+                return false;
+            }
+            entry->deferredFrames = 0;
+            return true;
+        }
+        void ran(BaseSystem* system) {
+            if (auto* entry = find(system)) {
+                entry->stats.runs++;
+                entry->condition.commit();
+            }
+        }
+        static void EndUpdate() {
+            auto& univ = Universe::get_instance();
+            univ.eventQueue.sendAll<TO_TYPE<EventPolish::AFTER_UPDATE>>();
+
+            univ.baseWorld.swap_buffers();
+            for (auto* world : univ.bufferedWorlds) world->swap_buffers();
+        }
+        static void RunPhase(const FramePhase phase) {
+            auto& univ = Universe::get_instance();
+            univ.phaseStart = std::chrono::steady_clock::now();
+
+            std::vector<BaseSystem*> systems;
+            for (const auto& entry : univ.systemList) {
+                if (entry.phase == phase) systems.push_back(entry.system);
+            }
+            for (auto batch : Universe::ScheduleSystems(systems)) {
+                batch.erase(std::remove_if(batch.begin(), batch.end(), [&univ](BaseSystem* system) { return !univ.admit(system); }), batch.end());
+                if (batch.empty()) continue;
+                if (batch.size() == 1) {
+                    batch.front()->Update();
+                    univ.ran(batch.front());
+                    univ.eventQueue.sendAll<TO_TYPE<EventPolish::AFTER_SYSTEM>>();
+                    continue;
+                }
+                for (auto* system : batch) {
+                    for (auto* prepare : system->Access()->prepare) prepare();
+                }
+                // Queued events are staged per system and replayed in batch order, as if the batch had run sequentially.
+                std::vector<UniverseEventQueue> staged(batch.size());
+                univ.workers.run(batch.size(), [&](const size_t i) {
+                    Scope bound(univ); // workers serve this universe only for the task
+                    stagedEvents = &staged[i];
+                    try {
+                        batch[i]->Update();
+                    }
+                    catch (...) {
+                        stagedEvents = nullptr;
+                        throw;
+                    }
+                    stagedEvents = nullptr;
+                });
+                for (auto* system : batch) univ.ran(system);
+                for (auto& events : staged) {
+                    events.moveAll<TO_TYPE<EventPolish::AFTER_SYSTEM>>(univ.eventQueue);
+                    events.moveAll<TO_TYPE<EventPolish::AFTER_UPDATE>>(univ.eventQueue);
+                    univ.eventQueue.sendAll<TO_TYPE<EventPolish::AFTER_SYSTEM>>();
+                }
+            }
+        }
+
+        // Null for the process-wide universe, which uses the process-wide Context.
+        std::unique_ptr<Context> context;
+        static inline thread_local Universe* current = nullptr;
+
         LEapsGL::BaseWorld baseWorld;
         std::vector<std::shared_ptr<__internal::RootWorld>> serialized;
+        std::vector<__internal::RootWorld*> bufferedWorlds;
 
         // Systems
-        vector<LEapsGL::BaseSystem*> systemList;
+        struct RegisteredSystem {
+            RegisteredSystem(LEapsGL::BaseSystem* sys, const FramePhase phase, const SystemPriority priority, RunCondition condition)
+                : system(sys), phase(phase), priority(priority), condition(std::move(condition)) {};
+
+            LEapsGL::BaseSystem* system;
+            FramePhase phase;
+            SystemPriority priority;
+            RunCondition condition;
+            unsigned deferredFrames = 0;
+            SystemStats stats{};
+        };
+        vector<RegisteredSystem> systemList;
+
+        // Frame loop
+        FrameSettings frameSettings;
+        FrameTime frameTime;
+        std::chrono::steady_clock::time_point frameStart;
+        std::chrono::steady_clock::time_point phaseStart;
+        std::chrono::nanoseconds accumulator{ 0 };
+        std::chrono::nanoseconds millisecondCarry{ 0 };
 
         // Event System
         unordered_map<size_t, std::vector<__internal::BaseEventSubscriber*>, std::hash<size_t>> subscribers;
-        EventQueue<TO_TYPE<EventPolish::DIRECT>, TO_TYPE<EventPolish::AFTER_SYSTEM>, TO_TYPE<EventPolish::AFTER_UPDATE>> eventQueue;
+        using UniverseEventQueue = EventQueue<TO_TYPE<EventPolish::DIRECT>, TO_TYPE<EventPolish::AFTER_SYSTEM>, TO_TYPE<EventPolish::AFTER_UPDATE>>;
+        UniverseEventQueue eventQueue;
+        // Events queued by a system running on a worker (see Update).
+        static inline thread_local UniverseEventQueue* stagedEvents = nullptr;
+        // No threads until SetWorkerCount/CreateInstance asks for them.
+        TaskPool workers{ 0 };
+        // Emission counts of the event types some RunCondition::Emitted waits for.
+        std::unordered_map<size_t, std::atomic<std::uint64_t>> emitted;
+        friend class RunCondition;
+
+        // Timers
+        struct CallbackDispatcher : BaseDispatcher {
+            CallbackDispatcher(std::function<void()> f) : fn(std::move(f)) {};
+
+            virtual void send() override {
+                fn();
+            }
+            std::function<void()> fn;
+        };
+        TimerWheel frameTimers;
+        TimerWheel clockTimers;
+        std::optional<std::chrono::steady_clock::time_point> lastUpdate;
+
+#ifdef LEAPS_COROUTINES_AVAILABLE
+        // Coroutines
+        struct CoroutineWaiterBase {
+            virtual ~CoroutineWaiterBase() {};
+            virtual void cancel(std::uint64_t id) = 0;
+        };
+        // Permanently subscribed; hands each emitted Event to the coroutines waiting for it.
+        template <typename Event>
+        struct EventWaiter : public EventSubscriber<Event>, public CoroutineWaiterBase {
+            virtual void receive(const Event& event) override {
+                auto& univ = Universe::get_instance();
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex); // emit may run on a worker
+                for (auto& [id, slot] : waiting) {
+                    *slot = event;
+                    univ.readyCoroutines.push_back(id);
+                }
+                waiting.clear();
+            }
+            virtual void cancel(const std::uint64_t id) override {
+                waiting.erase(std::remove_if(waiting.begin(), waiting.end(), [id](const auto& entry) { return entry.first == id; }), waiting.end());
+            }
+            std::vector<std::pair<std::uint64_t, std::optional<Event>*>> waiting;
+        };
+        struct CoroutineJob {
+            std::uint64_t id;
+            std::function<bool()> finished;
+        };
+
+        // Call with coroutineMutex held.
+        template <typename Event>
+        EventWaiter<Event>& assureEventWaiter() {
+            auto& waiter = eventWaiters[get_type_hash<Event>()];
+            if (!waiter) {
+                auto created = std::make_unique<EventWaiter<Event>>();
+                Universe::subscribe<Event>(created.get());
+                waiter = std::move(created);
+            }
+            return static_cast<EventWaiter<Event>&>(*waiter);
+        }
+        static void MarkCoroutineReady(const std::uint64_t id) {
+            auto& univ = Universe::get_instance();
+            std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+            univ.readyCoroutines.push_back(id);
+        }
+        static void ResumeCoroutine(const std::uint64_t id, const Coroutine::handle_type handle) {
+            auto& univ = Universe::get_instance();
+            const std::uint64_t outer = std::exchange(univ.runningCoroutine, id);
+            handle.resume();
+            univ.runningCoroutine = outer;
+            if (!handle.done()) return;
+
+            const std::exception_ptr error = handle.promise().error;
+            {
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                univ.coroutines.erase(id);
+            }
+            handle.destroy();
+            if (error) std::rethrow_exception(error);
+        }
+        static void ResumeCoroutines() {
+            auto& univ = Universe::get_instance();
+            std::deque<std::uint64_t> ready;
+            {
+                std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                for (auto iter = univ.coroutineJobs.begin(); iter != univ.coroutineJobs.end();) {
+                    if (!iter->finished()) {
+                        ++iter;
+                        continue;
+                    }
+                    univ.readyCoroutines.push_back(iter->id);
+                    iter = univ.coroutineJobs.erase(iter);
+                }
+                ready.swap(univ.readyCoroutines);
+                ready.insert(ready.end(), univ.nextFrameCoroutines.begin(), univ.nextFrameCoroutines.end());
+                univ.nextFrameCoroutines.clear();
+            }
+
+            size_t remaining = univ.frameSettings.maxCoroutineResumes ? univ.frameSettings.maxCoroutineResumes : SIZE_MAX;
+            while (!ready.empty() && remaining > 0) {
+                const std::uint64_t id = ready.front();
+                ready.pop_front();
+
+                Coroutine::handle_type handle;
+                {
+                    std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                    auto iter = univ.coroutines.find(id);
+                    if (iter == univ.coroutines.end()) continue; // stopped while waiting
+                    handle = iter->second;
+                }
+                remaining--;
+                try {
+                    Universe::ResumeCoroutine(id, handle);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+                    univ.readyCoroutines.insert(univ.readyCoroutines.begin(), ready.begin(), ready.end());
+                    throw;
+                }
+            }
+            // Over the per-frame limit: first in line next frame.
+            std::lock_guard<std::mutex> lock(univ.coroutineMutex);
+            univ.readyCoroutines.insert(univ.readyCoroutines.begin(), ready.begin(), ready.end());
+        }
+
+        std::mutex coroutineMutex;
+        std::unordered_map<std::uint64_t, Coroutine::handle_type> coroutines;
+        std::uint64_t lastCoroutine = 0;
+        std::uint64_t runningCoroutine = 0;
+        std::deque<std::uint64_t> readyCoroutines;
+        std::vector<std::uint64_t> nextFrameCoroutines;
+        std::vector<CoroutineJob> coroutineJobs;
+        std::unordered_map<size_t, std::unique_ptr<CoroutineWaiterBase>> eventWaiters;
+#endif
     };
+
+    namespace __internal {
+        template <typename Type>
+        struct component_access {
+            // Concurrent reads are safe only where even the mutable get() / view path leaves the pool untouched.
+            static constexpr bool shared_reads = !std::is_same_v<traits::to_allocation_meta_t<Type>, AllocationType::CopyOnWrite>
+                && !std::is_same_v<traits::to_container_meta_t<Type>, ContainerType::Cold>;
+            static constexpr bool double_buffered = std::is_same_v<traits::to_container_meta_t<Type>, ContainerType::DoubleBuffered>;
+
+            // Create the world (a context object) and the pool up front; neither may be inserted from a worker.
+            static void prepare() {
+                Universe::GetRelativeWorld<Type>().template assureComponent<Type>();
+                if constexpr (std::is_same_v<traits::to_entity_t<Type>, BaseEntityType>) Universe::GetBaseWorld().template assureComponent<Type>();
+            }
+        };
+    }
+
+    template <typename... Types>
+    RunCondition RunCondition::Changed() {
+        return RunCondition::Changed<Types...>(Universe::GetRelativeWorld<Types...>());
+    }
+    template <typename Event>
+    RunCondition RunCondition::Emitted() {
+        const auto& counter = Universe::get_instance().emitted[get_type_hash<Event>()];
+        auto seen = std::make_shared<std::uint64_t>(0);
+        return RunCondition(
+            [&counter, seen]() { return counter.load(std::memory_order_relaxed) != *seen; },
+            [&counter, seen]() { *seen = counter.load(std::memory_order_relaxed); });
+    }
+    inline RunCondition RunCondition::EveryNthFrame(const std::uint64_t n, const std::uint64_t offset) {
+        if (n == 0) throw std::invalid_argument("RunCondition: frame interval must be positive");
+        return RunCondition([n, offset]() { return Universe::GetFrameTime().frame % n == offset % n; });
+    }
 }
 
 
@@ -85,7 +85,7 @@ namespace LEapsGL {
             return static_cast<version_type>(to_integral(value) >> length);
         }
         [[nodiscard]] static constexpr value_type construct(const entity_type entity, const version_type version) noexcept {
-            return value_type{ (entity & entity_mask) | (static_cast<entity_type>(version) << length) };
+            return value_type{ (entity & entity_mask) | ((static_cast<entity_type>(version) & version_mask) << length) };
         }
         [[nodiscard]] static constexpr value_type next_version(const value_type value) noexcept {
             const auto vers = to_version(value) + 1;
@@ -133,7 +133,8 @@ namespace LEapsGL {
         template<typename Entity>
         [[nodiscard]] constexpr operator Entity() const noexcept {
             using traits_type = entity_traits<Entity>;
-            constexpr auto value = traits_type::construct(traits_type::invalid, traits_type::invalid);
+            // version_type may be wider than version_mask (uint32 handles keep 12 of its 16 bits).
+            constexpr auto value = traits_type::construct(traits_type::invalid, static_cast<typename traits_type::version_type>(traits_type::version_mask));
             return value;
         }
         [[nodiscard]] constexpr bool operator==([[maybe_unused]] const null_entity other) const noexcept {
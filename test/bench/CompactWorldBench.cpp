@@ -0,0 +1,56 @@
+/*
+    Memory and random-lookup cost of 64-bit BaseEntityType against 32-bit CompactEntityType handles
+    (README, "Compact Entity Handles"): 1M entities with one float component, lookups in shuffled order.
+        c++ -O2 -std=c++20 -Itest/core/stub -Iinclude test/bench/CompactWorldBench.cpp
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <core/World.h>
+
+using namespace LEapsGL;
+
+namespace {
+    constexpr int entity_count = 1000000;
+    constexpr int rounds = 20;
+
+    template <typename Entity>
+    struct Value {
+        using entity_type = Entity;
+        using instance_type = float;
+    };
+
+    template <typename Entity>
+    void run(const char* name) {
+        World<Entity> world;
+        std::vector<Entity> entities;
+        entities.reserve(entity_count);
+        for (int i = 0; i < entity_count; i++) {
+            const auto e = world.Create();
+            world.template emplace<Value<Entity>>(e, 1.0f);
+            entities.push_back(e);
+        }
+        std::shuffle(entities.begin(), entities.end(), std::mt19937(1));
+
+        auto& pool = world.template assure<Value<Entity>>();
+        const size_t bytes = pool.sparse_memory_usage() + pool.packed.capacity() * sizeof(Entity);
+
+        const auto start = std::chrono::steady_clock::now();
+        double sum = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (const auto e : entities) sum += pool.contains(e) ? pool.get(e) : 0.0;
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-18s sparse + packed %6zu KB   random lookup %5.1f ns/op   (checksum %.0f)\n",
+            name, bytes / 1024, ns / (static_cast<double>(rounds) * entity_count), sum);
+    }
+}
+
+int main() {
+    run<BaseEntityType>("BaseEntityType");
+    run<CompactEntityType>("CompactEntityType");
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+    Cost of World::save_frame / restore_frame for 100k entities over a 60-frame ring, with 1%, 10% and 100%
+    of Pos written between saves (Pos/Vel/Tag are CopyOnWrite, Hp is copied whole).
+        c++ -O2 -std=c++20 -Itest/core/stub -Iinclude test/bench/RollbackBench.cpp
+    Prints save time per frame, restore time and the resident-memory growth of the ring; exits non-zero if a
+    restored or re-simulated frame does not reproduce the saved state.
+*/
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <core/World.h>
+
+using namespace LEapsGL;
+
+namespace {
+    struct V3 {
+        float x, y, z;
+    };
+    struct Pos {
+        using instance_type = V3;
+        using allocation_type = AllocationType::CopyOnWrite;
+    };
+    struct Vel {
+        using instance_type = V3;
+        using allocation_type = AllocationType::CopyOnWrite;
+    };
+    struct Hp {
+        using instance_type = int;
+    };
+    struct Tag {
+        using container_type = ContainerType::Flag;
+        using allocation_type = AllocationType::CopyOnWrite;
+    };
+
+    constexpr int entity_count = 100000;
+    constexpr int ring_size = 60;
+
+    using clock = std::chrono::steady_clock;
+
+    double elapsed_us(const clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(clock::now() - start).count();
+    }
+
+    long resident_kb() {
+        std::ifstream status("/proc/self/status");
+        std::string key;
+        while (status >> key) {
+            if (key == "VmRSS:") {
+                long kb = -1;
+                status >> kb;
+                return kb;
+            }
+        }
+        return -1;
+    }
+
+    double checksum(World<>& world) {
+        const auto& pos = std::as_const(world.assure<Pos>());
+        double sum = 0;
+        for (const auto e : world.view<Pos>()) sum += pos.get(e).x * (1 + (e & 0xFFFFF));
+        return sum + pos.size() * 7.0;
+    }
+
+    // Writes frac of the Pos values, starting at a frame-dependent offset so successive frames touch different pages.
+    void step(World<>& world, const std::vector<World<>::entity_type>& entities, const int frame, const double frac) {
+        auto& pos = world.assure<Pos>();
+        const auto& vel = std::as_const(world.assure<Vel>());
+        const size_t n = static_cast<size_t>(entities.size() * frac);
+        const size_t start = (static_cast<size_t>(frame) * 7919) % entities.size();
+        for (size_t i = 0; i < n; i++) {
+            const auto e = entities[(start + i) % entities.size()];
+            if (!pos.contains(e)) continue;
+            auto& p = pos.get(e);
+            const auto& v = vel.get(e);
+            p.x += v.x;
+            p.y += v.y;
+        }
+        world.patch<Hp>(entities[frame % entities.size()], [](int& hp) { hp--; });
+    }
+}
+
+int main() {
+    World<> world;
+    std::vector<World<>::entity_type> entities;
+    entities.reserve(entity_count);
+    for (int i = 0; i < entity_count; i++) {
+        const auto e = world.Create();
+        entities.push_back(e);
+        world.emplace<Pos>(e, V3{ static_cast<float>(i), 0, 0 });
+        world.emplace<Vel>(e, V3{ 1, 2, 3 });
+        world.emplace<Hp>(e, 100);
+        if (i % 10 == 0) world.emplace<Tag>(e);
+    }
+
+    for (const double frac : { 0.01, 0.1, 1.0 }) {
+        world.enable_rollback<Pos, Vel, Hp, Tag>(ring_size);
+        std::vector<double> sums;
+        std::vector<std::uint64_t> frames;
+        double save_us = 0, restore_us = 0;
+        const long rss_before = resident_kb();
+        for (int f = 0; f < ring_size; f++) {
+            step(world, entities, f, frac);
+            const auto start = clock::now();
+            frames.push_back(world.save_frame());
+            save_us += elapsed_us(start);
+            sums.push_back(checksum(world));
+        }
+        const long rss_after = resident_kb();
+
+        // Structural changes after the last save must be undone as well.
+        const auto born = world.Create();
+        world.emplace<Pos>(born, V3{});
+        world.remove<Pos>(entities[3]);
+        world.Destroy(entities[4]);
+
+        for (const int k : { 50, 30, 10 }) {
+            const auto start = clock::now();
+            world.restore_frame(frames[k]);
+            restore_us += elapsed_us(start);
+            if (checksum(world) != sums[k]) {
+                std::printf("frame %d restored wrong state\n", k);
+                return 1;
+            }
+        }
+        if (!world.valid(entities[4]) || !world.contains<Pos>(entities[3]) || world.valid(born)) return 2;
+        if (world.has_frame(frames[11]) || !world.has_frame(frames[10])) return 3;
+
+        // Re-simulating from frame 10 reproduces the discarded frames.
+        for (int f = 11; f <= 20; f++) {
+            step(world, entities, f, frac);
+            if (world.save_frame() != frames[f]) return 4;
+            if (checksum(world) != sums[f]) {
+                std::printf("frame %d re-simulated wrong state\n", f);
+                return 5;
+            }
+        }
+        std::printf("written %5.1f%%: save %8.1f us/frame, restore %8.1f us, ring of %d frames +%ld KB\n",
+            frac * 100, save_us / ring_size, restore_us / 3, ring_size, rss_after - rss_before);
+    }
+    return 0;
+}
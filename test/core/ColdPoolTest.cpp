@@ -0,0 +1,77 @@
+/*
+    ContainerType::Cold: views whose callbacks take const references read without marking pages for recompression.
+        c++ -std=c++20 -Itest/core/stub -Iinclude test/core/ColdPoolTest.cpp
+    Exits with the number of failed checks.
+*/
+#include <cstdio>
+
+#include <core/World.h>
+
+using namespace LEapsGL;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+    struct Archive {
+        using instance_type = float;
+        using container_type = ContainerType::Cold;
+    };
+    struct Hp {
+        using instance_type = int;
+    };
+
+    constexpr int entity_count = 20000;
+
+    void populate(World<>& world) {
+        for (int i = 0; i < entity_count; i++) {
+            const auto e = world.Create();
+            world.emplace<Archive>(e, static_cast<float>(i));
+            if (i % 4 == 0) world.emplace<Hp>(e, 1);
+        }
+        world.assure<Archive>().flush();
+    }
+
+    void const_callbacks_only_read() {
+        World<> world;
+        populate(world);
+        auto& pool = world.assure<Archive>();
+
+        double total = 0;
+        world.view<Archive>().each([&](const float& value) { total += value; });
+        CHECK(total == static_cast<double>(entity_count - 1) * entity_count / 2);
+        CHECK(pool.dirty_pages() == 0);
+
+        int joined = 0;
+        world.view<Hp, Archive>().each([&](World<>::entity_type, const int& hp, float value) { joined += hp; (void)value; });
+        CHECK(joined == entity_count / 4);
+        world.view<Archive, Hp>().each_prefetched([&](const float&, const int&) {});
+        CHECK(pool.dirty_pages() == 0);
+
+        world.freeze();
+        CHECK(world.frozen<Archive>().size() == entity_count);
+        CHECK(pool.dirty_pages() == 0);
+    }
+
+    void mutable_callbacks_still_write() {
+        World<> world;
+        populate(world);
+        world.view<Archive>().each([](float& value) { value += 1.0f; });
+        CHECK(world.assure<Archive>().dirty_pages() > 0);
+        world.view<Archive>().each([](auto& value) { value -= 1.0f; }); // generic: mutable path
+        world.view<Archive>().each([](auto& value) { value += 1.0f; });
+
+        double total = 0;
+        world.view<Archive>().each([&](const float& value) { total += value; });
+        CHECK(total == static_cast<double>(entity_count - 1) * entity_count / 2 + entity_count);
+    }
+}
+
+int main() {
+    const_callbacks_only_read();
+    mutable_callbacks_still_write();
+    std::printf("%s\n", failures == 0 ? "ok" : "failed");
+    return failures;
+}
@@ -0,0 +1,121 @@
+/*
+    32-bit CompactEntityType handles reached through Universe::GetRelativeWorld, Universe::View and Proxy.
+        c++ -std=c++20 -Itest/core/stub -Iinclude test/core/CompactWorldTest.cpp
+    Exits with the number of failed checks.
+*/
+#include <cstdio>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include <core/World.h>
+#include <core/Proxy.h>
+
+using namespace LEapsGL;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+    struct Position {
+        using entity_type = CompactEntityType;
+        using instance_type = float;
+    };
+    struct Velocity {
+        using entity_type = CompactEntityType;
+        using instance_type = float;
+    };
+
+    // Proxied into CompactWorld itself.
+    struct Mesh {
+        using entity_type = CompactEntityType;
+        using instance_type = int;
+    };
+    struct MeshSpecification : public ProxyRequestSpecification<Mesh> {
+        using component_type = Mesh;
+        using instance_type = traits::to_instance_t<component_type>;
+
+        int vertices = 0;
+
+        virtual instance_type generateInstance() const {
+            return vertices;
+        }
+        virtual size_t hash() override {
+            return static_cast<size_t>(vertices);
+        }
+    };
+
+    void relative_world_is_compact() {
+        static_assert(sizeof(CompactEntityType) == 4, "compact handles are 32-bit");
+        auto& world = Universe::GetRelativeWorld<Position, Velocity>();
+        static_assert(std::is_same_v<std::decay_t<decltype(world)>, CompactWorld>, "compact components resolve to CompactWorld");
+        CHECK(&world == &Universe::GetCompactWorld());
+
+        for (int i = 0; i < 100; i++) {
+            const auto e = world.Create();
+            world.emplace<Position>(e, static_cast<float>(i));
+            if (i % 2 == 0) world.emplace<Velocity>(e, 1.0f);
+        }
+        CHECK(world.size() == 100);
+        CHECK(world.assure<Position>().size() == 100);
+    }
+
+    void view_over_compact_pools() {
+        auto& world = Universe::GetCompactWorld();
+        int matched = 0;
+        for (auto e : Universe::View<Position, Velocity>()) {
+            world.assure<Position>().get(e) += world.assure<Velocity>().get(e);
+            matched++;
+        }
+        CHECK(matched == 50);
+
+        float total = 0;
+        for (auto e : world.view<Position>()) total += world.query<Position>(e);
+        CHECK(total == 4950.0f + 50.0f);
+    }
+
+    void id_space_is_bounded() {
+        using traits_type = entity_traits<CompactEntityType>;
+        CHECK(traits_type::entity_mask == 0xFFFFF);
+        CompactWorld world;
+        const auto first = world.Create();
+        CHECK(traits_type::to_entity(first) == 0);
+        world.Destroy(first);
+        const auto reused = world.Create();
+        CHECK(traits_type::to_entity(reused) == 0);
+        CHECK(traits_type::to_version(reused) == 1);
+
+        const CompactEntityType null = null_entity{};
+        CHECK(traits_type::to_entity(null) == traits_type::invalid);
+        CHECK(traits_type::to_version(null) == traits_type::version_mask);
+        CHECK(!traits_type::is_valid(null));
+        CHECK(null == null_entity{});
+    }
+
+    void proxy_uses_compact_handles() {
+        struct TextureGroup {};
+        static_assert(std::is_same_v<ProxyEntity<TextureGroup>::entity_type, CompactEntityType>, "proxy handles share the compact layout");
+        CHECK(!entity_traits<CompactEntityType>::is_valid(ProxyEntity<TextureGroup>{}));
+        MeshSpecification spec;
+        spec.vertices = 36;
+        {
+            auto requestor = ProxyTraits::Get<MeshSpecification>(spec);
+            CHECK(Proxy::assure(requestor) == 36);
+            auto again = ProxyTraits::Get<MeshSpecification>(spec);
+            CHECK(&Proxy::assure(again) == &Proxy::assure(requestor));
+            CHECK(Universe::GetCompactWorld().assure<Mesh>().size() == 1);
+        }
+        CHECK(ProxyRequestSpecification<Mesh>::Counter().empty());
+    }
+}
+
+int main() {
+    relative_world_is_compact();
+    view_over_compact_pools();
+    id_space_is_bounded();
+    proxy_uses_compact_handles();
+    std::printf("%s\n", failures == 0 ? "ok" : "failed");
+    return failures;
+}
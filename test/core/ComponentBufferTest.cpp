@@ -0,0 +1,146 @@
+/*
+    Dirty-range tracking of ContainerType::Tracked pools and its GL export (ComponentBuffer), checked
+    against the recording GL stub in test/core/stub. Build with test/core/stub ahead of the include path:
+        c++ -std=c++20 -Itest/core/stub -Iinclude test/core/ComponentBufferTest.cpp
+    Exits with the number of failed checks.
+*/
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <ComponentBuffer.h>
+
+using namespace LEapsGL;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+    struct Mat {
+        float m[4];
+    };
+    struct Model {
+        using container_type = ContainerType::Tracked;
+        using instance_type = Mat;
+    };
+
+    bool mirrored(BaseWorld& world) {
+        auto& pool = world.assure<Model>();
+        return gl_stub::store.size() >= pool.size() * sizeof(Mat)
+            && std::memcmp(gl_stub::store.data(), pool.data(), pool.size() * sizeof(Mat)) == 0;
+    }
+    std::vector<std::pair<size_t, size_t>> uploads() {
+        std::vector<std::pair<size_t, size_t>> out;
+        for (const auto& c : gl_stub::calls) {
+            if (c.kind == gl_stub::call_kind::SUB_DATA) out.emplace_back(c.offset / sizeof(Mat), c.size / sizeof(Mat));
+        }
+        return out;
+    }
+    void set(BaseWorld& world, const BaseEntityType entt, const float value) {
+        world.patch<Model>(entt, [value](Mat& m) { m.m[0] = value; });
+    }
+
+    void dirty_ranges_out_of_order() {
+        dirty_ranges dirty;
+        dirty.mark(5);
+        dirty.mark(8);
+        dirty.mark(0, 9);
+        dirty.coalesce(9);
+        CHECK(dirty.ranges().size() == 1);
+        CHECK(dirty.ranges().front() == dirty_ranges::range_type(0, 9));
+
+        dirty.clear();
+        dirty.mark(10);
+        dirty.mark(2);
+        dirty.mark(11);
+        dirty.mark(3);
+        dirty.coalesce(20);
+        CHECK((dirty.ranges() == std::vector<dirty_ranges::range_type>{ { 2, 4 }, { 10, 12 } }));
+
+        dirty.clear();
+        dirty.mark(3, 6);
+        dirty.mark(2, 7);
+        dirty.coalesce(5, 0);
+        CHECK((dirty.ranges() == std::vector<dirty_ranges::range_type>{ { 2, 5 } }));
+    }
+
+    void component_buffer_sync() {
+        BaseWorld world;
+        std::vector<BaseEntityType> entities;
+        for (int i = 0; i < 1000; i++) {
+            const auto entt = world.Create();
+            entities.push_back(entt);
+            world.emplace<Model>(entt, Mat{ { static_cast<float>(i) } });
+        }
+
+        ComponentBuffer<Model> buffer;
+        CHECK(buffer.sync(world) == 1000 * sizeof(Mat));
+        CHECK(gl_stub::count(gl_stub::call_kind::DATA) == 1);
+        CHECK(mirrored(world));
+
+        // Nothing changed: no upload at all.
+        gl_stub::calls.clear();
+        CHECK(buffer.sync(world) == 0);
+        CHECK(uploads().empty());
+
+        // Neighbouring patches merge; out-of-order ones still coalesce.
+        gl_stub::calls.clear();
+        set(world, entities[10], -1);
+        set(world, entities[11], -2);
+        set(world, entities[500], -3);
+        set(world, entities[12], -4);
+        CHECK(buffer.sync(world) == 4 * sizeof(Mat));
+        CHECK((uploads() == std::vector<std::pair<size_t, size_t>>{ { 10, 3 }, { 500, 1 } }));
+        CHECK(mirrored(world));
+
+        // Removal moves the last element into the hole.
+        gl_stub::calls.clear();
+        world.Destroy(entities[3]);
+        world.remove<Model>(entities[999]);
+        buffer.sync(world);
+        CHECK(buffer.size() == 998);
+        CHECK(mirrored(world));
+
+        // Gaps of up to merge_gap clean slots are sent as one call.
+        gl_stub::calls.clear();
+        set(world, entities[20], 5);
+        set(world, entities[23], 6);
+        CHECK(buffer.sync(world, 4) == 4 * sizeof(Mat));
+        CHECK(uploads().size() == 1);
+        CHECK(mirrored(world));
+
+        // A full mark after single patches must still cover the slots before them.
+        gl_stub::calls.clear();
+        set(world, entities[5], 7);
+        set(world, entities[8], 8);
+        world.view<Model>().each([](Mat& m) { m.m[1] = 1; }); // a write the pool cannot see
+        world.assure<Model>().mark_all_dirty();
+        CHECK(buffer.sync(world) == world.assure<Model>().size() * sizeof(Mat));
+        CHECK((uploads() == std::vector<std::pair<size_t, size_t>>{ { 0, world.assure<Model>().size() } }));
+        CHECK(mirrored(world));
+
+        // Prefab spawns are tracked like emplace.
+        gl_stub::calls.clear();
+        Prefab<> prefab;
+        prefab.set<Model>(Mat{ { 9 } });
+        world.instantiate(prefab, 2);
+        CHECK(buffer.sync(world) == 2 * sizeof(Mat));
+        CHECK(mirrored(world));
+
+        // Outgrowing the store re-specifies it once.
+        gl_stub::calls.clear();
+        for (int i = 0; i < 2000; i++) world.emplace<Model>(world.Create(), Mat{ { 1 } });
+        buffer.sync(world);
+        CHECK(gl_stub::count(gl_stub::call_kind::DATA) == 1);
+        CHECK(mirrored(world));
+    }
+}
+
+int main() {
+    dirty_ranges_out_of_order();
+    component_buffer_sync();
+    std::printf("%s\n", failures == 0 ? "ok" : "failed");
+    return failures;
+}
@@ -0,0 +1,83 @@
+/*
+    World::defragment_ids and clear() must never reissue a handle that was handed out before.
+        c++ -std=c++20 -Itest/core/stub -Iinclude test/core/DefragmentTest.cpp
+    Exits with the number of failed checks.
+*/
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include <core/World.h>
+
+using namespace LEapsGL;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+    struct Hp {
+        using instance_type = int;
+    };
+
+    using entity_type = World<>::entity_type;
+
+    void trimmed_ids_keep_their_versions() {
+        World<> world;
+        std::set<entity_type> issued;
+        std::vector<entity_type> entities;
+        for (int i = 0; i < 200; i++) {
+            const auto e = world.Create();
+            world.emplace<Hp>(e, i);
+            entities.push_back(e);
+            issued.insert(e);
+        }
+        for (int i = 20; i < 200; i++) world.Destroy(entities[i]);
+
+        const auto table = world.defragment_ids();
+        CHECK(world.size() == 20);
+        for (int i = 0; i < 20; i++) CHECK(world.query<Hp>(table(entities[i])) == i);
+
+        for (int i = 0; i < 180; i++) {
+            const auto e = world.Create();
+            CHECK(issued.count(e) == 0);
+            CHECK(!world.contains<Hp>(e));
+        }
+        for (int i = 20; i < 200; i++) CHECK(!world.valid(entities[i]));
+    }
+
+    void moved_ids_keep_their_versions() {
+        World<> world;
+        std::vector<entity_type> entities;
+        for (int i = 0; i < 10; i++) entities.push_back(world.Create());
+        for (int i = 0; i < 5; i++) world.Destroy(entities[i]);
+
+        const auto table = world.defragment_ids();
+        std::set<entity_type> issued(entities.begin(), entities.end());
+        for (int i = 5; i < 10; i++) {
+            CHECK(issued.count(table(entities[i])) == 0);
+            issued.insert(table(entities[i]));
+        }
+        for (int i = 0; i < 10; i++) CHECK(issued.count(world.Create()) == 0);
+    }
+
+    void clear_keeps_versions() {
+        World<> world;
+        const auto a = world.Create();
+        world.emplace<Hp>(a, 1);
+        world.clear();
+        const auto b = world.Create();
+        CHECK(b != a);
+        CHECK(!world.valid(a));
+        CHECK(!world.contains<Hp>(b));
+    }
+}
+
+int main() {
+    trimmed_ids_keep_their_versions();
+    moved_ids_keep_their_versions();
+    clear_keeps_versions();
+    std::printf("%s\n", failures == 0 ? "ok" : "failed");
+    return failures;
+}
@@ -0,0 +1,102 @@
+/*
+    World::freeze / frozen(): cached snapshots follow writes that frozen pools still allow.
+        c++ -std=c++20 -Itest/core/stub -Iinclude test/core/FreezeTest.cpp
+    Exits with the number of failed checks.
+*/
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include <core/World.h>
+
+using namespace LEapsGL;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+    struct Pos {
+        using instance_type = float;
+    };
+    struct Hp {
+        using instance_type = int;
+    };
+
+    float sum(const FrozenView<World<>::entity_type, Pos>& view) {
+        float total = 0;
+        view.each([&](const float& x) { total += x; });
+        return total;
+    }
+
+    void writes_refresh_snapshots() {
+        World<> world;
+        std::vector<World<>::entity_type> entities;
+        for (int i = 0; i < 4; i++) {
+            const auto e = world.Create();
+            world.emplace<Pos>(e, 1.0f);
+            world.emplace<Hp>(e, 10);
+            entities.push_back(e);
+        }
+        world.freeze();
+
+        const auto& first = world.frozen<Pos>();
+        CHECK(sum(first) == 4.0f);
+
+        bool threw = false;
+        try {
+            world.patch<Pos>(entities[0], [](float& x) { x = 0; });
+        }
+        catch (const std::logic_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+
+        world.get<Pos>()->get(entities[0]) = 5.0f;
+        const auto& second = world.frozen<Pos>();
+        CHECK(&second == &first); // rebuilt in place
+        CHECK(sum(second) == 8.0f);
+
+        for (auto e : world.view<Pos>()) world.assure<Pos>().get(e) = 2.0f;
+        CHECK(sum(world.frozen<Pos>()) == 8.0f);
+
+        world.disable(entities[1]);
+        CHECK(world.frozen<Pos>().size() == 3);
+        world.enable(entities[1]);
+        CHECK(world.frozen<Pos>().size() == 4);
+
+        // A snapshot over other pools is not touched by Hp writes.
+        world.assure<Hp>().get(entities[0]) = 0;
+        CHECK(sum(world.frozen<Pos>()) == 8.0f);
+    }
+
+    void partial_freeze() {
+        World<> world;
+        const auto e = world.Create();
+        world.emplace<Pos>(e, 1.0f);
+        world.emplace<Hp>(e, 10);
+        world.freeze<Pos>();
+
+        bool threw = false;
+        try {
+            world.frozen<Pos, Hp>();
+        }
+        catch (const std::logic_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(world.frozen<Pos>().size() == 1);
+
+        world.unfreeze();
+        world.patch<Pos>(e, [](float& x) { x = 3.0f; });
+        CHECK(world.query<Pos>(e) == 3.0f);
+    }
+}
+
+int main() {
+    writes_refresh_snapshots();
+    partial_freeze();
+    std::printf("%s\n", failures == 0 ? "ok" : "failed");
+    return failures;
+}
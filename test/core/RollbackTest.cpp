@@ -0,0 +1,91 @@
+/*
+    World rollback ring (enable_rollback / save_frame / restore_frame).
+        c++ -std=c++20 -Itest/core/stub -Iinclude test/core/RollbackTest.cpp
+    Exits with the number of failed checks.
+*/
+#include <cstdio>
+#include <stdexcept>
+
+#include <core/World.h>
+
+using namespace LEapsGL;
+
+namespace {
+    int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+    struct P {
+        using instance_type = int;
+        using allocation_type = AllocationType::CopyOnWrite;
+    };
+    struct Q {
+        using instance_type = int;
+    };
+
+    void restore_values_and_membership() {
+        World<> world;
+        const auto a = world.Create();
+        world.emplace<P>(a, 1);
+        world.enable_rollback<P>(8);
+        const auto frame = world.save_frame();
+
+        world.patch<P>(a, [](int& v) { v = 2; });
+        const auto b = world.Create();
+        world.emplace<P>(b, 3);
+        world.restore_frame(frame);
+
+        CHECK(world.query<P>(a) == 1);
+        CHECK(!world.valid(b));
+        CHECK(world.assure<P>().size() == 1);
+        CHECK(!world.has_frame(frame + 1));
+    }
+
+    // Entities born after the saved frame must not leave components behind in pools rollback does not cover.
+    void unlisted_pools_are_purged() {
+        World<> world;
+        const auto kept = world.Create();
+        world.emplace<Q>(kept, 10);
+        world.enable_rollback<P>(4);
+        const auto frame = world.save_frame();
+
+        const auto born = world.Create();
+        world.emplace<P>(born, 1);
+        world.emplace<Q>(born, 2);
+        world.patch<Q>(kept, [](int& v) { v = 11; });
+        world.restore_frame(frame);
+
+        const auto reissued = world.Create();
+        CHECK(reissued == born);
+        CHECK(!world.contains<Q>(reissued));
+        CHECK(!world.contains<P>(reissued));
+        CHECK(world.contains<Q>(kept));
+        CHECK(world.query<Q>(kept) == 11); // unlisted values are not rewound
+    }
+
+    void ring_limits() {
+        World<> world;
+        world.enable_rollback<P>(2);
+        const auto first = world.save_frame();
+        world.save_frame();
+        world.save_frame();
+        CHECK(!world.has_frame(first));
+        bool threw = false;
+        try {
+            world.restore_frame(first);
+        }
+        catch (const std::out_of_range&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+}
+
+int main() {
+    restore_values_and_membership();
+    unlisted_pools_are_purged();
+    ring_limits();
+    std::printf("%s\n", failures == 0 ? "ok" : "failed");
+    return failures;
+}
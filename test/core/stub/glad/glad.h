@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+    Recording stand-in for glad, so GL-facing code (ComponentBuffer.h) can be tested without a GPU.
+    Put test/core/stub ahead of the real glad on the include path. Every buffer call is appended to
+    gl_stub::calls, and the bytes of the bound GL_ARRAY_BUFFER are mirrored in gl_stub::store.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+typedef unsigned int GLenum;
+typedef unsigned int GLuint;
+typedef int GLsizei;
+typedef std::ptrdiff_t GLintptr;
+typedef std::ptrdiff_t GLsizeiptr;
+
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_DYNAMIC_DRAW 0x88E8
+
+namespace gl_stub {
+    enum class call_kind {
+        GEN, BIND, DATA, SUB_DATA, DELETE
+    };
+    struct call {
+        call_kind kind;
+        GLuint buffer;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    inline std::vector<call> calls;
+    inline std::vector<std::uint8_t> store;
+    inline GLuint bound = 0;
+    inline GLuint next = 1;
+
+    inline size_t count(const call_kind kind) {
+        size_t n = 0;
+        for (const auto& c : calls) n += c.kind == kind;
+        return n;
+    }
+}
+
+inline void glGenBuffers(const GLsizei n, GLuint* buffers) {
+    for (GLsizei i = 0; i < n; i++) {
+        buffers[i] = gl_stub::next++;
+        gl_stub::calls.push_back({ gl_stub::call_kind::GEN, buffers[i], 0, 0 });
+    }
+}
+inline void glBindBuffer(GLenum, const GLuint buffer) {
+    gl_stub::bound = buffer;
+    gl_stub::calls.push_back({ gl_stub::call_kind::BIND, buffer, 0, 0 });
+}
+inline void glBufferData(GLenum, const GLsizeiptr size, const void* data, GLenum) {
+    gl_stub::store.assign(static_cast<std::size_t>(size), 0);
+    if (data) std::memcpy(gl_stub::store.data(), data, static_cast<std::size_t>(size));
+    gl_stub::calls.push_back({ gl_stub::call_kind::DATA, gl_stub::bound, 0, static_cast<std::size_t>(size) });
+}
+inline void glBufferSubData(GLenum, const GLintptr offset, const GLsizeiptr size, const void* data) {
+    std::memcpy(gl_stub::store.data() + offset, data, static_cast<std::size_t>(size));
+    gl_stub::calls.push_back({ gl_stub::call_kind::SUB_DATA, gl_stub::bound, static_cast<std::size_t>(offset), static_cast<std::size_t>(size) });
+}
+inline void glDeleteBuffers(const GLsizei n, const GLuint* buffers) {
+    for (GLsizei i = 0; i < n; i++) gl_stub::calls.push_back({ gl_stub::call_kind::DELETE, buffers[i], 0, 0 });
+}
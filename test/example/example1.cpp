@@ -28,8 +28,6 @@ using Univ = LEapsGL::Universe;
 
 LEapsGL::Camera camera(glm::vec3(0.0f, 0.0f, 5.0f));
 
-float deltaTime = 0.0f;	//  Ӱ    ð
-float lastFrame = 0.0f; //   ð
 
 float lastX = SCR_WIDTH / 2, lastY = SCR_HEIGHT / 2;
 bool firstMouse = true;
@@ -60,7 +58,7 @@ class ModelMatrixCalcSystem : public LEapsGL::DefaultSystem {
 };
 
 struct Camera {
-    using container_type = LEapsGL::ContainerType::MemoryOptimized;
+    using container_type = LEapsGL::ContainerType::Unique;
     Camera(const LEapsGL::Camera& c, bool _active) : camera(c), active(_active) {};
 
     LEapsGL::Camera camera;
@@ -70,12 +68,10 @@ struct Camera {
 
 struct MeshRenderSystem : public LEapsGL::DefaultSystem {
     virtual void Update() override {
-        Univ::View<Camera>().each([](auto& cam) {
-            glm::mat4 view = camera.getViewMatrix();
+        auto& cam = Univ::GetBaseWorld().resource<Camera>();
+        glm::mat4 view = cam.camera.getViewMatrix();
         glm::mat4 proj = glm::mat4(1.0f);
-        proj = glm::perspective(glm::radians(camera.zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-
-            });
+        proj = glm::perspective(glm::radians(cam.camera.zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
     }
 };
 
@@ -101,7 +97,7 @@ public:
     void Update() {
         auto& glfw = LEapsGL::Context::getGlobalContext<LEapsGL::GLFWContext>();
 
-        float cameraSpeed = 2.5f * deltaTime;
+        const float deltaTime = static_cast<float>(Univ::GetFrameTime().deltaSeconds());
         if (glfwGetKey(glfw.getWindow(), GLFW_KEY_W) == GLFW_PRESS) camera.processKeyboard(FORWARD, deltaTime);
         if (glfwGetKey(glfw.getWindow(), GLFW_KEY_S) == GLFW_PRESS) camera.processKeyboard(BACKWARD, deltaTime);
         if (glfwGetKey(glfw.getWindow(), GLFW_KEY_A) == GLFW_PRESS) camera.processKeyboard(LEFT, deltaTime);
@@ -224,7 +220,7 @@ int main() {
 
     Univ::registerSystem(new CameraSystem());
     Univ::registerSystem(new InputSystem());
-    Univ::registerSystem(new ModelMatrixCalcSystem());
+    Univ::registerSystem(new ModelMatrixCalcSystem(), LEapsGL::RunCondition::Changed<Position, Scale>());
     Univ::registerSystem(new MeshRenderSystem());
 
     //glm::vec4 vec(1.0f, 0.0f, 0.0f, 1.0f);
@@ -372,10 +368,11 @@ int main() {
     /*
         [        Game loop        ]
     */
+    double elapsedTime = 0.0;
     while (!glfwWindowShouldClose(window)) {
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        Univ::Frame();
+        elapsedTime += Univ::GetFrameTime().deltaSeconds();
+        const float currentFrame = static_cast<float>(elapsedTime);
 
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f); // state setting
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // stage using
@@ -530,8 +527,6 @@ int main() {
         //img_raws[img_update_idx + 1] = upval;
         //img_raws[img_update_idx + 2] = upval;
         //img_update_idx = (img_update_idx + 3) % (img.width * img.height * img.nrChannels);
-
-        Univ::Update();
     }
 
     glfwTerminate();